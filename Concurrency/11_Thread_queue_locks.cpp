@@ -0,0 +1,439 @@
+// 11_Thread_queue_locks.cpp
+// clang++ -std=c++17 -O2 -pthread 11_Thread_queue_locks.cpp -o a; ./a
+// @author :  DhiraxD
+// @brief  : MCS and CLH queue locks - every waiter spins on its OWN node
+//           instead of all waiters hammering the single cache line of a mutex
+// References:
+// https://en.cppreference.com/w/cpp/atomic/atomic
+// https://en.cppreference.com/w/cpp/named_req/BasicLockable
+// https://en.cppreference.com/w/cpp/named_req/TimedLockable
+// https://www.cs.rochester.edu/research/synchronization/pseudocode/ss.html
+// "Algorithms for Scalable Synchronization on Shared-Memory Multiprocessors"
+//  - Mellor-Crummey & Scott, 1991
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+// -----------------------------------------------------------
+// Cache line size used for padding so that two nodes never share a line
+constexpr std::size_t CACHE_LINE = 64;
+
+// Polite busy-wait: "pause" for a while, then give the CPU away.
+// Yielding matters when there are more threads than cores - a spinning
+// waiter would otherwise burn the time slice the lock holder needs.
+inline void CpuRelax(int &spins) {
+    if (++spins < 100) {
+#if defined(__x86_64__) || defined(__i386__)
+        _mm_pause();
+#elif defined(__aarch64__)
+        asm volatile("yield");
+#endif
+    } else {
+        std::this_thread::yield();
+    }
+}
+
+// -----------------------------------------------------------
+// Per-thread cache of queue nodes.
+// Nodes migrate between threads (a releaser may recycle a node that another
+// thread allocated), so they are plain heap objects and every thread simply
+// keeps a free list. Nothing is malloc'ed on the hot path once warm.
+template <typename Node>
+class NodeCache {
+public:
+    static Node * Acquire() {
+        auto &list = Instance().m_Free;
+        if (list.empty()) {
+            return new Node;
+        }
+        Node *node = list.back();
+        list.pop_back();
+        return node;
+    }
+    static void Release(Node *node) {
+        Instance().m_Free.push_back(node);
+    }
+private:
+    ~NodeCache() {
+        for (Node *node : m_Free) delete node;
+    }
+    static NodeCache & Instance() {
+        thread_local NodeCache cache;
+        return cache;
+    }
+    std::vector<Node*> m_Free;
+};
+
+// -----------------------------------------------------------
+// Test-and-test-and-set spinlock (the baseline queue locks are compared to).
+// All waiters read the same flag, so every unlock invalidates the line in
+// every waiting core and they all race for it again.
+class TTASSpinLock {
+public:
+    void lock() {
+        int spins = 0;
+        while (true) {
+            if (!m_Locked.exchange(true, std::memory_order_acquire)) {
+                return;
+            }
+            while (m_Locked.load(std::memory_order_relaxed)) {
+                CpuRelax(spins);
+            }
+        }
+    }
+    bool try_lock() {
+        return !m_Locked.load(std::memory_order_relaxed) &&
+               !m_Locked.exchange(true, std::memory_order_acquire);
+    }
+    void unlock() {
+        m_Locked.store(false, std::memory_order_release);
+    }
+private:
+    alignas(CACHE_LINE) std::atomic<bool> m_Locked{false};
+};
+
+// -----------------------------------------------------------
+// MCS lock (Mellor-Crummey & Scott)
+//
+// Waiters form a linked list. A thread appends its node with one atomic
+// exchange on the tail and then spins ONLY on its own node. The releaser
+// hands the lock directly to its successor -> strict FIFO, O(1) remote
+// cache traffic per handoff.
+//
+// The lock is BasicLockable / TimedLockable, so std::lock_guard and
+// std::unique_lock work unchanged. The owner's node is remembered inside the
+// lock (only the owner touches m_Owner between lock() and unlock()).
+//
+// Timeout / abort: a timed waiter that gives up marks its node ABANDONED and
+// leaves. The node stays in the queue; the releaser skips abandoned nodes and
+// takes ownership of them (recycles them) on the way.
+class MCSLock {
+    enum State : int { WAITING, GRANTED, ABANDONED };
+
+    struct alignas(CACHE_LINE) QNode {
+        std::atomic<QNode*> next{nullptr};
+        std::atomic<int>    state{WAITING};
+    };
+    using Cache = NodeCache<QNode>;
+
+public:
+    MCSLock() = default;
+    MCSLock(const MCSLock&) = delete;
+    MCSLock & operator=(const MCSLock&) = delete;
+
+    void lock() {
+        QNode *node = Enqueue();
+        if (node != nullptr) {
+            int spins = 0;
+            while (node->state.load(std::memory_order_acquire) != GRANTED) {
+                CpuRelax(spins);
+            }
+            m_Owner = node;
+        }
+    }
+
+    // Succeeds only when the queue is empty (never waits)
+    bool try_lock() {
+        QNode *node = Cache::Acquire();
+        Reset(node);
+        QNode *expected = nullptr;
+        if (m_Tail.compare_exchange_strong(expected, node, std::memory_order_acq_rel)) {
+            m_Owner = node;
+            return true;
+        }
+        Cache::Release(node);
+        return false;
+    }
+
+    template <typename Rep, typename Period>
+    bool try_lock_for(const std::chrono::duration<Rep, Period> &timeout) {
+        return try_lock_until(std::chrono::steady_clock::now() + timeout);
+    }
+
+    template <typename Clock, typename Duration>
+    bool try_lock_until(const std::chrono::time_point<Clock, Duration> &deadline) {
+        QNode *node = Enqueue();
+        if (node == nullptr) {
+            return true;
+        }
+        int spins = 0;
+        while (node->state.load(std::memory_order_acquire) != GRANTED) {
+            if (Clock::now() >= deadline) {
+                int expected = WAITING;
+                if (node->state.compare_exchange_strong(expected, ABANDONED,
+                                                        std::memory_order_acq_rel)) {
+                    // The queue owns the node now - do NOT touch it again.
+                    return false;
+                }
+                break;  // granted at the last moment, keep it
+            }
+            CpuRelax(spins);
+        }
+        m_Owner = node;
+        return true;
+    }
+
+    void unlock() {
+        QNode *node = m_Owner;
+        while (true) {
+            QNode *succ = node->next.load(std::memory_order_acquire);
+            if (succ == nullptr) {
+                // No visible successor: try to swing the tail back to empty
+                QNode *expected = node;
+                if (m_Tail.compare_exchange_strong(expected, nullptr,
+                                                   std::memory_order_acq_rel)) {
+                    Cache::Release(node);
+                    return;
+                }
+                // Someone is enqueueing right now - wait for the link
+                int spins = 0;
+                while ((succ = node->next.load(std::memory_order_acquire)) == nullptr) {
+                    CpuRelax(spins);
+                }
+            }
+            Cache::Release(node);
+
+            int expected = WAITING;
+            if (succ->state.compare_exchange_strong(expected, GRANTED,
+                                                    std::memory_order_acq_rel)) {
+                return;  // direct handoff
+            }
+            // Successor timed out: we own its node, release "on its behalf"
+            node = succ;
+        }
+    }
+
+private:
+    static void Reset(QNode *node) {
+        node->next.store(nullptr, std::memory_order_relaxed);
+        node->state.store(WAITING, std::memory_order_relaxed);
+    }
+
+    // Returns nullptr when the lock was free and is now held by the caller,
+    // otherwise the node the caller has to wait on.
+    QNode * Enqueue() {
+        QNode *node = Cache::Acquire();
+        Reset(node);
+        QNode *pred = m_Tail.exchange(node, std::memory_order_acq_rel);
+        if (pred == nullptr) {
+            m_Owner = node;
+            return nullptr;
+        }
+        pred->next.store(node, std::memory_order_release);
+        return node;
+    }
+
+    alignas(CACHE_LINE) std::atomic<QNode*> m_Tail{nullptr};
+    alignas(CACHE_LINE) QNode *m_Owner = nullptr;
+};
+
+// -----------------------------------------------------------
+// CLH lock (Craig, Landin & Hagersten)
+//
+// Implicit queue: each thread swaps its node into the tail and spins on the
+// PREDECESSOR's flag. On unlock it clears its own flag and adopts the
+// predecessor's node for its next acquisition. One atomic per acquire, no
+// CAS at all on release.
+class CLHLock {
+    struct alignas(CACHE_LINE) QNode {
+        std::atomic<bool> locked{false};
+    };
+    using Cache = NodeCache<QNode>;
+
+public:
+    CLHLock() : m_Tail(new QNode) {}
+    ~CLHLock() { delete m_Tail.load(); }
+    CLHLock(const CLHLock&) = delete;
+    CLHLock & operator=(const CLHLock&) = delete;
+
+    void lock() {
+        QNode *node = Cache::Acquire();
+        node->locked.store(true, std::memory_order_relaxed);
+        QNode *pred = m_Tail.exchange(node, std::memory_order_acq_rel);
+        int spins = 0;
+        while (pred->locked.load(std::memory_order_acquire)) {
+            CpuRelax(spins);
+        }
+        m_Owner = node;
+        m_Pred  = pred;
+    }
+
+    void unlock() {
+        QNode *node = m_Owner;
+        QNode *pred = m_Pred;
+        node->locked.store(false, std::memory_order_release);  // successor now owns `node`
+        Cache::Release(pred);                                  // we now own `pred`
+    }
+
+private:
+    alignas(CACHE_LINE) std::atomic<QNode*> m_Tail;
+    alignas(CACHE_LINE) QNode *m_Owner = nullptr;
+    QNode *m_Pred = nullptr;
+};
+
+// -----------------------------------------------------------
+// Benchmark: the 5_Thread_mutex.cpp workload, N downloaders pushing into
+// one shared container under one lock, for a fixed wall-clock time.
+const auto RUN_FOR = std::chrono::milliseconds(200);
+
+struct alignas(CACHE_LINE) PerThread {
+    long long acquisitions = 0;
+};
+
+struct Result {
+    double mopsPerSec;
+    double fairness;    // max / min acquisitions per thread (1.0 == perfect)
+};
+
+template <typename Lock>
+Result RunBenchmark(int threads) {
+    Lock lock;
+    std::vector<int> data;            // plays the role of g_Data
+    data.reserve(1 << 20);
+    std::vector<PerThread> counts(threads);
+    std::atomic<int>  ready{0};
+    std::atomic<bool> start{false};
+    std::atomic<bool> stop{false};
+
+    auto Download = [&](int id) {
+        ready.fetch_add(1);
+        while (!start.load(std::memory_order_acquire)) std::this_thread::yield();
+        long long local = 0;
+        while (!stop.load(std::memory_order_relaxed)) {
+            {
+                std::lock_guard<Lock> guard(lock);
+                if (data.size() == data.capacity()) data.clear();
+                data.push_back(id);
+            }
+            ++local;
+        }
+        counts[id].acquisitions = local;
+    };
+
+    std::vector<std::thread> workers;
+    for (int i = 0; i < threads; ++i) workers.emplace_back(Download, i);
+    while (ready.load() != threads) std::this_thread::yield();
+
+    auto begin = std::chrono::steady_clock::now();
+    start.store(true, std::memory_order_release);
+    std::this_thread::sleep_for(RUN_FOR);
+    stop.store(true);
+    for (auto &t : workers) t.join();
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    long long total = 0, mn = counts[0].acquisitions, mx = counts[0].acquisitions;
+    for (auto &c : counts) {
+        total += c.acquisitions;
+        mn = std::min(mn, c.acquisitions);
+        mx = std::max(mx, c.acquisitions);
+    }
+    return { total / elapsed / 1e6, mn == 0 ? -1.0 : double(mx) / double(mn) };
+}
+
+template <typename Lock>
+void Report(const std::string &name) {
+    for (int threads : {2, 4, 8, 16, 32, 64}) {
+        Result r = RunBenchmark<Lock>(threads);
+        std::cout << std::left  << std::setw(12) << name
+                  << std::right << std::setw(8)  << threads
+                  << std::setw(14) << std::fixed << std::setprecision(3) << r.mopsPerSec;
+        if (r.fairness < 0) std::cout << std::setw(14) << "starved";
+        else                std::cout << std::setw(14) << std::setprecision(2) << r.fairness;
+        std::cout << std::endl;
+    }
+}
+
+// -----------------------------------------------------------
+int main() {
+    std::cout << "[main] hardware threads: " << std::thread::hardware_concurrency() << std::endl;
+
+    // Step 1: lock_guard / unique_lock compatibility and timeout
+    {
+        MCSLock mcs;
+        std::unique_lock<MCSLock> held(mcs);
+        std::thread waiter([&] {
+            bool got = mcs.try_lock_for(std::chrono::milliseconds(50));
+            std::cout << "[main] try_lock_for while held -> "
+                      << (got ? "acquired" : "timed out") << std::endl;
+            if (got) mcs.unlock();
+        });
+        waiter.join();
+        held.unlock();
+        std::lock_guard<MCSLock> again(mcs);  // the abandoned node was skipped
+        std::cout << "[main] lock after abandoned waiter -> acquired" << std::endl;
+    }
+
+    // Step 2: throughput + fairness
+    std::cout << std::left  << std::setw(12) << "lock"
+              << std::right << std::setw(8)  << "threads"
+              << std::setw(14) << "Mops/s" << std::setw(14) << "max/min" << std::endl;
+    Report<std::mutex>("std::mutex");
+    Report<TTASSpinLock>("TTAS");
+    Report<MCSLock>("MCS");
+    Report<CLHLock>("CLH");
+
+    return 0;
+}
+
+/* ------------------------------------------------------------------
+THEORY & KEY POINTS: Queue locks
+
+1. Why a plain lock stops scaling:
+   - std::mutex / a TTAS spinlock keep ONE word of state.
+   - Every waiter reads that word → every unlock invalidates the cache line
+     in every waiting core, then they all race (thundering herd).
+   - Whoever happens to win the race gets the lock → no FIFO, a thread can
+     starve while a "lucky" core re-acquires again and again.
+
+2. MCS lock:
+   - tail.exchange(myNode) appends me to a queue (one atomic, wait-free).
+   - pred->next = myNode links me behind my predecessor.
+   - I spin on myNode->state only → local spinning, no shared hot line.
+   - unlock(): hand the lock to next (or swing tail back to nullptr).
+   - Strict FIFO → max/min acquisitions per thread stays close to 1.
+
+3. CLH lock:
+   - Same idea, but the queue is implicit: I spin on my PREDECESSOR's flag.
+   - unlock() is a single store (no CAS), then I recycle pred's node.
+   - Great on cache-coherent machines; on NUMA the predecessor's node may be
+     remote memory, which is why MCS is preferred there.
+
+4. Timeout / abort (try_lock_for):
+   - A waiter that gives up cannot just unlink itself (it would race with
+     its neighbours). Instead it marks its node ABANDONED and walks away.
+   - The releaser skips abandoned nodes and reclaims them.
+
+5. The flip side of fairness:
+   - A FIFO lock must hand off to a SPECIFIC thread. If that thread is
+     preempted (more threads than cores), everyone waits for the scheduler
+     → "convoys". Run this on a machine with few cores and watch MCS/CLH
+     throughput collapse while TTAS/std::mutex just let a running thread in.
+   - Real systems combine both: spin a little, then park (futex).
+
+6. lock_guard compatibility:
+   - Providing lock()/unlock() (BasicLockable) is enough for std::lock_guard.
+   - try_lock / try_lock_for / try_lock_until (TimedLockable) make
+     std::unique_lock's timed API work as well.
+   - The owner's node is stored inside the lock, so no extra argument is
+     needed - only the owner reads it between lock() and unlock().
+
+------------------------------------------------------------------
+
+💡 Memory Tip / Analogy
+	•	std::mutex = crowd around one door, whoever pushes hardest goes first.
+	•	MCS = a queue where the person in front taps YOUR shoulder when done.
+	•	CLH = a queue where you watch the person in front of you; when they leave, it's your turn.
+	•	try_lock_for = leaving the queue but leaving a "skip me" note on your spot.
+
+*/
@@ -0,0 +1,434 @@
+// 12_Thread_reader_writer_locks.cpp
+// clang++ -std=c++17 -O2 -pthread 12_Thread_reader_writer_locks.cpp -o a; ./a
+// @author :  DhiraxD
+// @brief  : Reader-writer locks for read-mostly data
+//           - PhaseFairRWLock : ticket based, readers and writers alternate in phases
+//           - BravoLock<RW>   : wrapper that adds a distributed reader indicator
+//                               (BRAVO) on top of any shared_mutex-like lock
+// References:
+// https://en.cppreference.com/w/cpp/thread/shared_mutex
+// https://en.cppreference.com/w/cpp/thread/shared_lock
+// https://en.cppreference.com/w/cpp/named_req/SharedLockable
+// "BRAVO - Biased Locking for Reader-Writer Locks" - Dice & Kogan, USENIX ATC 2019
+// "Spin-Based Reader-Writer Synchronization for Multiprocessor Real-Time Systems"
+//  - Brandenburg & Anderson, 2010 (phase-fair ticket lock, PF-T)
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <shared_mutex>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+// -----------------------------------------------------------
+constexpr std::size_t CACHE_LINE = 64;
+
+// Spin a little with "pause", then yield so the lock holder can run
+inline void CpuRelax(int &spins) {
+    if (++spins < 100) {
+#if defined(__x86_64__) || defined(__i386__)
+        _mm_pause();
+#elif defined(__aarch64__)
+        asm volatile("yield");
+#endif
+    } else {
+        std::this_thread::yield();
+    }
+}
+
+inline std::int64_t NowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// -----------------------------------------------------------
+// Phase-fair ticket RW lock (PF-T)
+//
+// rin/rout count readers in/out (in steps of RINC). The low two bits of rin
+// say "a writer is present" (PRES) and which writer phase it is (PHID).
+// - A reader that arrives while a writer is present waits only until THAT
+//   writer's phase ends, then goes in → readers never starve.
+// - Writers queue on a ticket (win/wout) and block newly arriving readers the
+//   moment they announce themselves → a writer waits for at most one read
+//   phase, so writers are preferred over a continuous stream of readers.
+class PhaseFairRWLock {
+    static constexpr std::uint32_t RINC  = 0x100;
+    static constexpr std::uint32_t WBITS = 0x3;
+    static constexpr std::uint32_t PRES  = 0x2;
+    static constexpr std::uint32_t PHID  = 0x1;
+
+public:
+    void lock_shared() {
+        std::uint32_t w = m_Rin.fetch_add(RINC, std::memory_order_acquire) & WBITS;
+        int spins = 0;
+        while (w != 0 && w == (m_Rin.load(std::memory_order_acquire) & WBITS)) {
+            CpuRelax(spins);
+        }
+    }
+
+    // Succeeds only if no writer is present or queued; never waits
+    bool try_lock_shared() {
+        std::uint32_t rin = m_Rin.load(std::memory_order_relaxed);
+        return (rin & WBITS) == 0 &&
+               m_Rin.compare_exchange_strong(rin, rin + RINC, std::memory_order_acquire, std::memory_order_relaxed);
+    }
+
+    void unlock_shared() {
+        m_Rout.fetch_add(RINC, std::memory_order_release);
+    }
+
+    void lock() {
+        int spins = 0;
+        std::uint32_t ticket = m_Win.fetch_add(1, std::memory_order_relaxed);
+        while (ticket != m_Wout.load(std::memory_order_acquire)) {
+            CpuRelax(spins);
+        }
+        std::uint32_t w = PRES | (ticket & PHID);
+        std::uint32_t readers = m_Rin.fetch_add(w, std::memory_order_acq_rel);
+        while (readers != m_Rout.load(std::memory_order_acquire)) {
+            CpuRelax(spins);
+        }
+    }
+
+    // Take a ticket only if no writer holds or waits for one, then enter only
+    // if no reader is inside; otherwise give the ticket straight back
+    bool try_lock() {
+        std::uint32_t ticket = m_Wout.load(std::memory_order_acquire);
+        std::uint32_t expected = ticket;
+        if (!m_Win.compare_exchange_strong(expected, ticket + 1, std::memory_order_relaxed)) {
+            return false;
+        }
+        std::uint32_t readers = m_Rin.load(std::memory_order_relaxed);
+        if (readers == m_Rout.load(std::memory_order_acquire) &&
+            m_Rin.compare_exchange_strong(readers, readers | PRES | (ticket & PHID), std::memory_order_acq_rel,
+                                          std::memory_order_relaxed)) {
+            return true;
+        }
+        m_Wout.fetch_add(1, std::memory_order_release);
+        return false;
+    }
+
+    void unlock() {
+        m_Rin.fetch_and(~WBITS, std::memory_order_release);
+        m_Wout.fetch_add(1, std::memory_order_release);
+    }
+
+private:
+    alignas(CACHE_LINE) std::atomic<std::uint32_t> m_Rin{0};
+    alignas(CACHE_LINE) std::atomic<std::uint32_t> m_Rout{0};
+    alignas(CACHE_LINE) std::atomic<std::uint32_t> m_Win{0};
+    alignas(CACHE_LINE) std::atomic<std::uint32_t> m_Wout{0};
+};
+
+// -----------------------------------------------------------
+// BRAVO wrapper: shared_mutex-compatible, works on top of any RW lock
+//
+// While the lock is "reader biased", a reader does not touch the underlying
+// lock at all: it publishes itself in one slot of a global, cache-line padded
+// visible-readers table (chosen by hashing thread + lock address). Readers on
+// different cores therefore write different cache lines → reads scale.
+//
+// A writer takes the underlying lock, turns the bias off and waits until no
+// slot points at this lock any more (revocation). Because revocation is
+// expensive, the bias stays off for a while (INHIBIT_MULTIPLIER x the time
+// the revocation took) so write-heavy phases don't pay it every time.
+template <typename Underlying = std::shared_mutex>
+class BravoLock {
+    static constexpr std::size_t TABLE_SIZE = 1024;
+    static constexpr std::int64_t INHIBIT_MULTIPLIER = 9;
+
+    struct alignas(CACHE_LINE) Slot {
+        std::atomic<const void*> owner{nullptr};
+    };
+
+    // Fast-path reads held by the current thread (lock → slot), so that
+    // unlock_shared() knows which path was taken without any extra argument.
+    struct FastHeld {
+        static constexpr int MAX = 16;
+        const void *lock[MAX] = {};
+        Slot       *slot[MAX] = {};
+        int         count = 0;
+    };
+
+public:
+    BravoLock() = default;
+    BravoLock(const BravoLock&) = delete;
+    BravoLock & operator=(const BravoLock&) = delete;
+
+    void lock_shared() {
+        if (TryFastRead()) {
+            return;
+        }
+        m_Lock.lock_shared();
+        // Slow path is the place to re-enable the bias once the inhibit window is over
+        if (!m_ReaderBias.load(std::memory_order_relaxed) &&
+            NowNs() >= m_InhibitUntil.load(std::memory_order_relaxed)) {
+            m_ReaderBias.store(true, std::memory_order_release);
+        }
+    }
+
+    bool try_lock_shared() {
+        return TryFastRead() || m_Lock.try_lock_shared();
+    }
+
+    void unlock_shared() {
+        FastHeld &held = Held();
+        for (int i = held.count - 1; i >= 0; --i) {
+            if (held.lock[i] == this) {
+                held.slot[i]->owner.store(nullptr, std::memory_order_release);
+                held.lock[i] = held.lock[held.count - 1];
+                held.slot[i] = held.slot[held.count - 1];
+                --held.count;
+                return;
+            }
+        }
+        m_Lock.unlock_shared();
+    }
+
+    void lock() {
+        m_Lock.lock();
+        Revoke();
+    }
+
+    bool try_lock() {
+        if (!m_Lock.try_lock()) {
+            return false;
+        }
+        if (!Revoke(false)) {       // a fast-path reader is still inside: do not wait for it
+            m_Lock.unlock();
+            return false;
+        }
+        return true;
+    }
+
+    void unlock() {
+        m_Lock.unlock();
+    }
+
+private:
+    static FastHeld & Held() {
+        thread_local FastHeld held;
+        return held;
+    }
+
+    Slot & SlotFor() const {
+        thread_local const std::size_t threadHash =
+            std::hash<std::thread::id>{}(std::this_thread::get_id());
+        std::size_t h = threadHash ^ (reinterpret_cast<std::uintptr_t>(this) >> 6);
+        h *= 0x9E3779B97F4A7C15ull;
+        return s_Table[(h >> 32) % TABLE_SIZE];
+    }
+
+    bool TryFastRead() {
+        if (!m_ReaderBias.load(std::memory_order_acquire)) {
+            return false;
+        }
+        FastHeld &held = Held();
+        if (held.count == FastHeld::MAX) {
+            return false;
+        }
+        Slot &slot = SlotFor();
+        const void *expected = nullptr;
+        if (!slot.owner.compare_exchange_strong(expected, this, std::memory_order_seq_cst)) {
+            return false;  // slot taken (hash collision) → slow path
+        }
+        // Re-check: a writer may have revoked the bias between the load and the CAS
+        if (m_ReaderBias.load(std::memory_order_seq_cst)) {
+            held.lock[held.count] = this;
+            held.slot[held.count] = &slot;
+            ++held.count;
+            return true;
+        }
+        slot.owner.store(nullptr, std::memory_order_release);
+        return false;
+    }
+
+    // Called with the underlying lock held exclusively. With wait == false it
+    // returns false instead of waiting for a fast-path reader (bias stays off).
+    bool Revoke(bool wait = true) {
+        if (!m_ReaderBias.load(std::memory_order_relaxed)) {
+            return true;
+        }
+        m_ReaderBias.store(false, std::memory_order_seq_cst);
+        std::int64_t start = NowNs();
+        for (Slot &slot : s_Table) {
+            int spins = 0;
+            while (slot.owner.load(std::memory_order_seq_cst) == this) {
+                if (!wait) {
+                    return false;
+                }
+                CpuRelax(spins);
+            }
+        }
+        std::int64_t now = NowNs();
+        m_InhibitUntil.store(now + (now - start) * INHIBIT_MULTIPLIER, std::memory_order_relaxed);
+        return true;
+    }
+
+    static inline Slot s_Table[TABLE_SIZE];
+
+    alignas(CACHE_LINE) std::atomic<bool> m_ReaderBias{true};
+    std::atomic<std::int64_t> m_InhibitUntil{0};
+    Underlying m_Lock;
+};
+
+// -----------------------------------------------------------
+// Benchmark: readers print g_Data.size()-style reads, writers push_back.
+// Each configuration runs for a fixed wall-clock time.
+const auto RUN_FOR = std::chrono::milliseconds(100);
+
+template <typename Lock>
+double RunBenchmark(int threads, int writePercent) {
+    Lock lock;
+    std::vector<int> data(64, 1);     // plays the role of g_Data
+    std::atomic<int>  ready{0};
+    std::atomic<bool> start{false};
+    std::atomic<bool> stop{false};
+    std::atomic<long long> totalOps{0};
+
+    auto Worker = [&](int id) {
+        std::uint32_t rng = 0x9E3779B9u * (id + 1);
+        long long ops = 0;
+        long long sink = 0;
+        ready.fetch_add(1);
+        while (!start.load(std::memory_order_acquire)) std::this_thread::yield();
+        while (!stop.load(std::memory_order_relaxed)) {
+            rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5;
+            if (static_cast<int>(rng % 100) < writePercent) {
+                std::lock_guard<Lock> guard(lock);
+                if (data.size() > 4096) data.resize(64);
+                data.push_back(id);
+            } else {
+                std::shared_lock<Lock> guard(lock);
+                sink += static_cast<long long>(data.size()) + data.front() + data.back();
+            }
+            ++ops;
+        }
+        totalOps.fetch_add(ops + (sink == -1));
+    };
+
+    std::vector<std::thread> workers;
+    for (int i = 0; i < threads; ++i) workers.emplace_back(Worker, i);
+    while (ready.load() != threads) std::this_thread::yield();
+
+    auto begin = std::chrono::steady_clock::now();
+    start.store(true, std::memory_order_release);
+    std::this_thread::sleep_for(RUN_FOR);
+    stop.store(true);
+    for (auto &t : workers) t.join();
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    return totalOps.load() / elapsed / 1e6;
+}
+
+template <typename Lock>
+void Report(const std::string &name, int writePercent) {
+    std::cout << std::left << std::setw(22) << name << std::right;
+    for (int threads : {1, 2, 4, 8, 16, 32, 64}) {
+        std::cout << std::setw(9) << std::fixed << std::setprecision(2)
+                  << RunBenchmark<Lock>(threads, writePercent);
+    }
+    std::cout << std::endl;
+}
+
+// -----------------------------------------------------------
+int main() {
+    std::cout << "[main] hardware threads: " << std::thread::hardware_concurrency() << std::endl;
+
+    // Step 1: drop-in for std::shared_mutex (shared_lock / unique_lock / lock_guard)
+    {
+        BravoLock<PhaseFairRWLock> rw;
+        std::shared_lock<BravoLock<PhaseFairRWLock>> r1(rw);
+        std::thread reader([&] {
+            std::shared_lock<BravoLock<PhaseFairRWLock>> r2(rw);  // readers share
+            std::cout << "[main] second reader got in while first holds the lock" << std::endl;
+        });
+        reader.join();
+        std::unique_lock<BravoLock<PhaseFairRWLock>> tryWriter(rw, std::try_to_lock);
+        std::cout << "[main] try_lock while a reader holds it: " << tryWriter.owns_lock() << std::endl;
+        r1.unlock();
+        std::unique_lock<BravoLock<PhaseFairRWLock>> w(rw);
+        std::cout << "[main] writer got exclusive access" << std::endl;
+        std::thread tryReader([&] {
+            std::shared_lock<BravoLock<PhaseFairRWLock>> r3(rw, std::try_to_lock);
+            std::cout << "[main] try_lock_shared while the writer holds it: " << r3.owns_lock() << std::endl;
+        });
+        tryReader.join();
+        w.unlock();
+        std::shared_lock<BravoLock<PhaseFairRWLock>> r4(rw, std::try_to_lock);
+        std::cout << "[main] try_lock_shared once it is free: " << r4.owns_lock() << std::endl;
+    }
+
+    // Step 2: Mops/s for each read/write mix
+    for (int writePercent : {1, 10, 50}) {
+        std::cout << "\nread/write " << (100 - writePercent) << "/" << writePercent
+                  << "  (Mops/s)\n";
+        std::cout << std::left << std::setw(22) << "lock \\ threads" << std::right;
+        for (int threads : {1, 2, 4, 8, 16, 32, 64}) std::cout << std::setw(9) << threads;
+        std::cout << std::endl;
+        Report<std::shared_mutex>("std::shared_mutex", writePercent);
+        Report<PhaseFairRWLock>("PhaseFair", writePercent);
+        Report<BravoLock<std::shared_mutex>>("BRAVO<shared_mutex>", writePercent);
+        Report<BravoLock<PhaseFairRWLock>>("BRAVO<PhaseFair>", writePercent);
+    }
+
+    return 0;
+}
+
+/* ------------------------------------------------------------------
+THEORY & KEY POINTS: Reader-writer locks
+
+1. Why not just std::mutex?
+   - Reads of g_Data (size(), iteration) don't modify anything, yet an
+     exclusive mutex lets only ONE reader in at a time.
+   - A reader-writer lock lets many readers in together; writers are exclusive.
+
+2. The hidden cost of a "normal" RW lock:
+   - Every lock_shared()/unlock_shared() updates a reader COUNT.
+   - That count lives in one cache line → readers on different cores still
+     fight over it, so read-only workloads don't scale as expected.
+
+3. BRAVO (reader bias):
+   - Readers publish themselves in a slot of a big, padded table instead of
+     the shared count → no shared write on the read path.
+   - Writer: take the underlying lock, set bias=false, wait until no slot
+     still names this lock ("revocation").
+   - Revocation is slow (scan the table) → bias is disabled for a window
+     proportional to that cost. Write-heavy phases fall back to the
+     underlying lock automatically.
+   - It is a WRAPPER: BravoLock<std::shared_mutex>, BravoLock<PhaseFairRWLock> ...
+
+4. Phase-fair lock:
+   - Reader-preferring locks can starve writers; writer-preferring ones can
+     starve readers.
+   - Phase-fair: read phases and write phases alternate.
+     • A writer that arrives blocks all NEW readers → it waits at most for
+       the readers already inside.
+     • Readers that arrive during a write phase go in as soon as that single
+       writer leaves → they wait at most one writer.
+
+5. shared_mutex compatibility:
+   - lock()/unlock()/lock_shared()/unlock_shared() (+ try_ variants) is all
+     std::shared_lock, std::unique_lock and std::lock_guard need.
+
+6. Rule of thumb:
+   - 50/50 mix → plain mutex is often just as good.
+   - 90/10 → RW lock helps.
+   - 99/1 with many cores → reader-biased (BRAVO / per-core) locks win big.
+
+------------------------------------------------------------------
+
+💡 Memory Tip / Analogy
+	•	std::shared_mutex = a library with one visitor counter at the door everybody must click.
+	•	BRAVO = everyone signs a different page of the guest book; the librarian only checks the book when closing for repairs (writes).
+	•	Phase-fair = traffic lights: readers get green, then one writer, then readers again.
+
+*/
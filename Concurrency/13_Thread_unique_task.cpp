@@ -0,0 +1,399 @@
+// 13_Thread_unique_task.cpp
+// clang++ -std=c++17 -O2 -pthread 13_Thread_unique_task.cpp -o a; ./a
+// @author :  DhiraxD
+// @brief  : unique_task<Sig> - a move-only, small-buffer-optimized callable
+//           (std::move_only_function backport) used as the task type of a
+//           thread pool queue, so submitting a task does not call malloc
+// References:
+// https://en.cppreference.com/w/cpp/utility/functional/function
+// https://en.cppreference.com/w/cpp/utility/functional/move_only_function
+// https://en.cppreference.com/w/cpp/thread/packaged_task
+// https://en.cppreference.com/w/cpp/memory/new/operator_new
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <functional>
+#include <atomic>
+#include <chrono>
+#include <new>
+#include <cstdlib>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <array>
+#include <string>
+#include <algorithm>
+
+// -----------------------------------------------------------
+// Count every heap allocation in the program (for the benchmark)
+std::atomic<long long> g_Allocations{0};
+
+// noinline: see Memory Management/1_Memory_object_pool.cpp
+[[gnu::noinline]] void * operator new(std::size_t size) {
+    g_Allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+[[gnu::noinline]] void operator delete(void *p) noexcept { std::free(p); }
+[[gnu::noinline]] void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+// -----------------------------------------------------------
+// unique_task<R(Args...), InlineSize>
+//
+// - Move-only: can hold move-only callables (std::packaged_task, lambdas
+//   capturing std::unique_ptr) which std::function cannot.
+// - Callables up to InlineSize bytes (and nothrow-movable) live inside the
+//   object itself → no allocation. Bigger ones fall back to the heap.
+// - Type erasure through one static table of function pointers per callable
+//   type (no virtual, no RTTI).
+template <typename Sig, std::size_t InlineSize = 48>
+class unique_task;
+
+template <typename R, typename... Args, std::size_t InlineSize>
+class unique_task<R(Args...), InlineSize> {
+    static_assert(InlineSize >= sizeof(void*), "inline buffer must hold at least a pointer");
+
+    struct VTable {
+        R    (*invoke)(void *storage, Args&&... args);
+        void (*move)(void *dst, void *src) noexcept;     // move-construct dst, destroy src
+        void (*destroy)(void *storage) noexcept;
+    };
+
+    template <typename F>
+    static constexpr bool FitsInline =
+        sizeof(F) <= InlineSize &&
+        alignof(F) <= alignof(std::max_align_t) &&
+        std::is_nothrow_move_constructible<F>::value;
+
+    template <typename F>
+    struct InlineOps {
+        static F * Get(void *s) { return std::launder(reinterpret_cast<F*>(s)); }
+        static R Invoke(void *s, Args&&... args) {
+            if constexpr (std::is_void<R>::value) {
+                std::invoke(*Get(s), std::forward<Args>(args)...);     // void task: drop the result
+            } else {
+                return std::invoke(*Get(s), std::forward<Args>(args)...);
+            }
+        }
+        static void Move(void *dst, void *src) noexcept {
+            ::new (dst) F(std::move(*Get(src)));
+            Get(src)->~F();
+        }
+        static void Destroy(void *s) noexcept { Get(s)->~F(); }
+        static constexpr VTable table{&Invoke, &Move, &Destroy};
+    };
+
+    template <typename F>
+    struct HeapOps {
+        static F *& Get(void *s) { return *std::launder(reinterpret_cast<F**>(s)); }
+        static R Invoke(void *s, Args&&... args) {
+            if constexpr (std::is_void<R>::value) {
+                std::invoke(*Get(s), std::forward<Args>(args)...);     // void task: drop the result
+            } else {
+                return std::invoke(*Get(s), std::forward<Args>(args)...);
+            }
+        }
+        static void Move(void *dst, void *src) noexcept {
+            ::new (dst) F*(Get(src));
+        }
+        static void Destroy(void *s) noexcept { delete Get(s); }
+        static constexpr VTable table{&Invoke, &Move, &Destroy};
+    };
+
+public:
+    static constexpr std::size_t inline_size = InlineSize;
+
+    unique_task() noexcept = default;
+    unique_task(std::nullptr_t) noexcept {}
+
+    template <typename F,
+              typename D = std::decay_t<F>,
+              typename = std::enable_if_t<!std::is_same<D, unique_task>::value &&
+                                          std::is_invocable_r<R, D&, Args...>::value>>
+    unique_task(F &&f) {
+        if constexpr (FitsInline<D>) {
+            ::new (static_cast<void*>(m_Storage)) D(std::forward<F>(f));
+            m_VTable = &InlineOps<D>::table;
+        } else {
+            ::new (static_cast<void*>(m_Storage)) D*(new D(std::forward<F>(f)));
+            m_VTable = &HeapOps<D>::table;
+        }
+    }
+
+    unique_task(unique_task &&other) noexcept {
+        if (other.m_VTable) {
+            other.m_VTable->move(m_Storage, other.m_Storage);
+            m_VTable = std::exchange(other.m_VTable, nullptr);
+        }
+    }
+
+    unique_task & operator=(unique_task &&other) noexcept {
+        if (this != &other) {
+            reset();
+            if (other.m_VTable) {
+                other.m_VTable->move(m_Storage, other.m_Storage);
+                m_VTable = std::exchange(other.m_VTable, nullptr);
+            }
+        }
+        return *this;
+    }
+
+    unique_task(const unique_task&) = delete;
+    unique_task & operator=(const unique_task&) = delete;
+
+    ~unique_task() { reset(); }
+
+    void reset() noexcept {
+        if (m_VTable) {
+            m_VTable->destroy(m_Storage);
+            m_VTable = nullptr;
+        }
+    }
+
+    explicit operator bool() const noexcept { return m_VTable != nullptr; }
+
+    // Calling an empty (or moved-from) task throws std::bad_function_call, like std::function
+    R operator()(Args... args) {
+        if (m_VTable == nullptr) throw std::bad_function_call();
+        return m_VTable->invoke(m_Storage, std::forward<Args>(args)...);
+    }
+
+private:
+    alignas(std::max_align_t) unsigned char m_Storage[InlineSize];
+    const VTable *m_VTable = nullptr;
+};
+
+// -----------------------------------------------------------
+// Minimal thread pool, parameterized on the task type stored in its queue
+// (same mutex + condition_variable hand-off as 10_Thread_ConditionVariable_example.cpp)
+template <typename Task>
+class ThreadPool {
+public:
+    explicit ThreadPool(unsigned workers) {
+        for (unsigned i = 0; i < workers; ++i) {
+            m_Workers.emplace_back([this] { WorkerLoop(); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Stop = true;
+        }
+        m_CV.notify_all();
+        for (auto &t : m_Workers) t.join();
+    }
+
+    // Fire-and-forget
+    template <typename F>
+    void Submit(F &&f) {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Queue.emplace_back(std::forward<F>(f));
+        }
+        m_CV.notify_one();
+    }
+
+    // Returns a future, like std::async
+    template <typename F, typename R = std::invoke_result_t<std::decay_t<F>&>>
+    std::future<R> Async(F &&f) {
+        std::packaged_task<R()> task(std::forward<F>(f));
+        std::future<R> result = task.get_future();
+        if constexpr (!std::is_copy_constructible<Task>::value) {
+            Submit(std::move(task));    // move-only task type holds packaged_task directly
+        } else {
+            // std::function needs a copyable target → extra shared_ptr allocation
+            auto shared = std::make_shared<std::packaged_task<R()>>(std::move(task));
+            Submit([shared] { (*shared)(); });
+        }
+        return result;
+    }
+
+private:
+    void WorkerLoop() {
+        while (true) {
+            Task task;
+            {
+                std::unique_lock<std::mutex> lock(m_Mutex);
+                m_CV.wait(lock, [this] { return m_Stop || !m_Queue.empty(); });
+                if (m_Queue.empty()) return;   // stop requested and drained
+                task = std::move(m_Queue.front());
+                m_Queue.pop_front();
+            }
+            task();
+        }
+    }
+
+    std::mutex m_Mutex;
+    std::condition_variable m_CV;
+    std::deque<Task> m_Queue;
+    bool m_Stop = false;
+    std::vector<std::thread> m_Workers;
+};
+
+// -----------------------------------------------------------
+// Benchmark helpers
+template <std::size_t Bytes>
+struct Capture {
+    std::array<char, Bytes> payload{};
+};
+
+template <typename Task, std::size_t Bytes>
+double AllocationsPerTask(int count) {
+    Capture<Bytes> capture;
+    std::vector<Task> tasks;
+    tasks.reserve(count);
+    long long before = g_Allocations.load();
+    for (int i = 0; i < count; ++i) {
+        tasks.emplace_back([capture]() mutable { capture.payload[0]++; });
+    }
+    long long after = g_Allocations.load();
+    for (auto &t : tasks) t();
+    return double(after - before) / count;
+}
+
+template <std::size_t Bytes>
+void ReportAllocations() {
+    const int COUNT = 10000;
+    std::cout << std::setw(10) << Bytes
+              << std::setw(16) << AllocationsPerTask<std::function<void()>, Bytes>(COUNT)
+              << std::setw(20) << AllocationsPerTask<unique_task<void(), 48>, Bytes>(COUNT)
+              << std::setw(20) << AllocationsPerTask<unique_task<void(), 64>, Bytes>(COUNT)
+              << std::endl;
+}
+
+template <typename Task>
+void SubmitThroughput(const std::string &name, bool withFuture) {
+    const int TASKS = 1000000;
+    const unsigned WORKERS = std::max(2u, std::thread::hardware_concurrency());
+    std::atomic<long long> sum{0};
+    Capture<40> capture;               // ~5 words: too big for std::function's SBO
+
+    long long before = g_Allocations.load();
+    auto begin = std::chrono::steady_clock::now();
+    {
+        ThreadPool<Task> pool(WORKERS);
+        if (withFuture) {
+            std::vector<std::future<int>> results;
+            results.reserve(TASKS);
+            for (int i = 0; i < TASKS; ++i) {
+                results.push_back(pool.Async([capture, i] { return i + capture.payload[0]; }));
+            }
+            for (auto &r : results) sum += r.get();
+        } else {
+            for (int i = 0; i < TASKS; ++i) {
+                pool.Submit([capture, i, &sum] {
+                    sum.fetch_add(i + capture.payload[0], std::memory_order_relaxed);
+                });
+            }
+        }
+    }
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    long long allocations = g_Allocations.load() - before;
+
+    std::cout << std::left << std::setw(30) << name << std::right
+              << std::setw(12) << std::fixed << std::setprecision(2) << TASKS / elapsed / 1e6
+              << std::setw(16) << std::setprecision(3) << double(allocations) / TASKS
+              << std::endl;
+}
+
+// -----------------------------------------------------------
+int Add(int a, int b) { return a + b; }
+
+int main() {
+    // Step 1: what std::function cannot do - hold a move-only packaged_task
+    {
+        std::packaged_task<int(int,int)> task1{Add};
+        std::future<int> result1 = task1.get_future();
+        unique_task<void()> job{[t = std::move(task1)]() mutable { t(10, 20); }};
+        std::thread t1{std::move(job)};
+        std::cout << "[main] Addition is : " << result1.get() << std::endl;
+        t1.join();
+
+        // A void task may wrap a callable that returns a value; the value is dropped
+        unique_task<void()> ignoresResult{[] { return Add(1, 2); }};
+        ignoresResult();
+        unique_task<void()> newOwner = std::move(ignoresResult);
+        try {
+            ignoresResult();
+        } catch (const std::bad_function_call &) {
+            std::cout << "[main] calling a moved-from task throws std::bad_function_call" << std::endl;
+        }
+    }
+
+    // Step 2: heap allocations needed just to construct one task
+    std::cout << "\nallocations per task (lower is better)\n"
+              << std::setw(10) << "capture B"
+              << std::setw(16) << "std::function"
+              << std::setw(20) << "unique_task<48>"
+              << std::setw(20) << "unique_task<64>" << std::endl;
+    ReportAllocations<8>();
+    ReportAllocations<16>();
+    ReportAllocations<32>();
+    ReportAllocations<48>();
+    ReportAllocations<64>();
+    ReportAllocations<128>();
+
+    // Step 3: pool submit throughput
+    std::cout << "\npool throughput, 1M tasks capturing ~48 bytes\n"
+              << std::left << std::setw(30) << "queue task type" << std::right
+              << std::setw(12) << "Mtasks/s" << std::setw(16) << "allocs/task" << std::endl;
+    SubmitThroughput<std::function<void()>>("std::function  Submit", false);
+    SubmitThroughput<unique_task<void(), 64>>("unique_task<64> Submit", false);
+    SubmitThroughput<std::function<void()>>("std::function  Async(future)", true);
+    SubmitThroughput<unique_task<void(), 64>>("unique_task<64> Async(future)", true);
+
+    return 0;
+}
+
+/* ------------------------------------------------------------------
+THEORY & KEY POINTS: Small-buffer, move-only tasks
+
+1. Where do the mallocs come from?
+   - std::function stores small callables inline (typically 16 bytes,
+     i.e. 2 pointers). Anything bigger → new on construction.
+   - std::function must be COPYABLE, so a move-only std::packaged_task has
+     to be wrapped in a shared_ptr first → one more allocation.
+   - std::packaged_task itself allocates its shared state (future/promise
+     channel; libstdc++ also allocates the result slot) - that cannot be
+     avoided without a custom future type.
+
+2. unique_task<Sig, N>:
+   - An N-byte aligned buffer inside the object holds the callable.
+   - A per-type static table { invoke, move, destroy } replaces virtual calls.
+   - Callables larger than N (or with a throwing move) go to the heap,
+     so correctness never depends on the size.
+   - Move-only, like C++23 std::move_only_function.
+   - unique_task<void()> accepts callables returning a value (result dropped);
+     calling an empty task throws std::bad_function_call.
+
+3. Why the callable's move must be noexcept for the inline path:
+   - Moving the task (into/out of the queue) moves the callable.
+   - If that could throw, the queue could be left half-updated.
+   - Heap-stored callables move by copying a pointer → always noexcept.
+
+4. Pool + queue:
+   - The queue stores Task objects by value (std::deque<Task>).
+   - With unique_task, submit = construct in place + one mutex hand-off.
+   - Async() can push the packaged_task itself: only the packaged_task's
+     own allocations remain, the std::function + shared_ptr ones are gone.
+
+5. Choosing N:
+   - Bigger N → fewer heap fallbacks, but every queue slot gets bigger.
+   - 48-64 bytes (one cache line incl. vtable pointer) covers most
+     lambdas capturing a few values and a reference.
+
+------------------------------------------------------------------
+
+💡 Memory Tip / Analogy
+	•	std::function = a suitcase that only holds a toothbrush; anything bigger is shipped separately (malloc).
+	•	unique_task<64> = a carry-on that fits a whole day's gear; only oversized items get checked in.
+	•	Move-only = there is exactly one boarding pass; you can hand it over, not photocopy it.
+
+*/
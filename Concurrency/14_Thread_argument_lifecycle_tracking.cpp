@@ -0,0 +1,352 @@
+// 14_Thread_argument_lifecycle_tracking.cpp
+// clang++ -std=c++17 -O2 -pthread 14_Thread_argument_lifecycle_tracking.cpp -o a; ./a
+// @author :  DhiraxD
+// @brief  : Tracked<T> - counts what happens to an argument on its way into a thread
+//           (default/copy/move constructions, assignments, destructions and the
+//           heap bytes duplicated by copies), per type and per thread.
+//           Replaces the hand-written printing String of 2_Thread_pass_arguments.cpp
+//           with numbers we can CHECK, so an extra copy becomes a failing run.
+// References:
+// https://en.cppreference.com/w/cpp/thread/thread/thread
+// https://en.cppreference.com/w/cpp/thread/async
+// https://en.cppreference.com/w/cpp/thread/packaged_task
+// https://en.cppreference.com/w/cpp/utility/functional/ref
+// https://en.cppreference.com/w/cpp/language/rule_of_three
+
+#include <iostream>
+#include <iomanip>
+#include <thread>
+#include <future>
+#include <functional>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <type_traits>
+#include <utility>
+
+// -----------------------------------------------------------
+// Plain counters (one set per type, plus one set per type per thread)
+struct LifecycleCounts {
+    long long defaultCtor = 0;
+    long long valueCtor   = 0;   // constructed from a T / constructor arguments
+    long long copyCtor    = 0;
+    long long moveCtor    = 0;
+    long long copyAssign  = 0;
+    long long moveAssign  = 0;
+    long long dtor        = 0;
+    long long heapBytes   = 0;   // bytes of heap duplicated by copies
+
+    long long Copies() const { return copyCtor + copyAssign; }
+    long long Moves()  const { return moveCtor + moveAssign; }
+
+    LifecycleCounts operator-(const LifecycleCounts &o) const {
+        LifecycleCounts d;
+        d.defaultCtor = defaultCtor - o.defaultCtor;
+        d.valueCtor   = valueCtor   - o.valueCtor;
+        d.copyCtor    = copyCtor    - o.copyCtor;
+        d.moveCtor    = moveCtor    - o.moveCtor;
+        d.copyAssign  = copyAssign  - o.copyAssign;
+        d.moveAssign  = moveAssign  - o.moveAssign;
+        d.dtor        = dtor        - o.dtor;
+        d.heapBytes   = heapBytes   - o.heapBytes;
+        return d;
+    }
+};
+
+std::ostream & operator<<(std::ostream &os, const LifecycleCounts &c) {
+    return os << "default=" << c.defaultCtor << " value=" << c.valueCtor
+              << " copy=" << c.copyCtor << " move=" << c.moveCtor
+              << " copyAssign=" << c.copyAssign << " moveAssign=" << c.moveAssign
+              << " dtor=" << c.dtor << " heapBytes=" << c.heapBytes;
+}
+
+// -----------------------------------------------------------
+// Heap footprint of a value, if we can tell (std::string, std::vector ...)
+template <typename T, typename = void>
+struct HasCapacity : std::false_type {};
+template <typename T>
+struct HasCapacity<T, std::void_t<decltype(std::declval<const T&>().capacity()),
+                                  typename T::value_type>> : std::true_type {};
+
+template <typename T>
+long long HeapBytesOf(const T &value) {
+    if constexpr (HasCapacity<T>::value) {
+        return static_cast<long long>(value.capacity() * sizeof(typename T::value_type));
+    } else {
+        return 0;
+    }
+}
+
+// -----------------------------------------------------------
+// Tracked<T>: wraps a T and counts every special member call.
+// Global counters are atomics (threads are involved by design); every thread
+// additionally has its own thread_local set, so we can see WHERE a copy ran.
+template <typename T>
+class Tracked {
+public:
+    Tracked() { Count(&LifecycleCounts::defaultCtor); }
+
+    template <typename... Args,
+              typename = std::enable_if_t<std::is_constructible<T, Args&&...>::value &&
+                                          !(sizeof...(Args) == 1 &&
+                                            (std::is_same<std::decay_t<Args>, Tracked>::value && ...))>>
+    explicit Tracked(Args&&... args) : m_Value(std::forward<Args>(args)...) {
+        Count(&LifecycleCounts::valueCtor);
+    }
+
+    Tracked(const Tracked &other) : m_Value(other.m_Value) {
+        Count(&LifecycleCounts::copyCtor, HeapBytesOf(m_Value));
+    }
+    Tracked(Tracked &&other) noexcept(std::is_nothrow_move_constructible<T>::value)
+        : m_Value(std::move(other.m_Value)) {
+        Count(&LifecycleCounts::moveCtor);
+    }
+    Tracked & operator=(const Tracked &other) {
+        m_Value = other.m_Value;
+        Count(&LifecycleCounts::copyAssign, HeapBytesOf(m_Value));
+        return *this;
+    }
+    Tracked & operator=(Tracked &&other) noexcept(std::is_nothrow_move_assignable<T>::value) {
+        m_Value = std::move(other.m_Value);
+        Count(&LifecycleCounts::moveAssign);
+        return *this;
+    }
+    ~Tracked() { Count(&LifecycleCounts::dtor); }
+
+    T & get() { return m_Value; }
+    const T & get() const { return m_Value; }
+
+    // ---- reporting ----
+    static LifecycleCounts Totals() {
+        LifecycleCounts c;
+        auto &g = Global();
+        c.defaultCtor = g.defaultCtor.load();
+        c.valueCtor   = g.valueCtor.load();
+        c.copyCtor    = g.copyCtor.load();
+        c.moveCtor    = g.moveCtor.load();
+        c.copyAssign  = g.copyAssign.load();
+        c.moveAssign  = g.moveAssign.load();
+        c.dtor        = g.dtor.load();
+        c.heapBytes   = g.heapBytes.load();
+        return c;
+    }
+    static LifecycleCounts ThisThread() { return Local(); }
+
+private:
+    struct AtomicCounts {
+        std::atomic<long long> defaultCtor{0}, valueCtor{0}, copyCtor{0}, moveCtor{0},
+                               copyAssign{0}, moveAssign{0}, dtor{0}, heapBytes{0};
+        std::atomic<long long> & operator[](long long LifecycleCounts::*field) {
+            if (field == &LifecycleCounts::defaultCtor) return defaultCtor;
+            if (field == &LifecycleCounts::valueCtor)   return valueCtor;
+            if (field == &LifecycleCounts::copyCtor)    return copyCtor;
+            if (field == &LifecycleCounts::moveCtor)    return moveCtor;
+            if (field == &LifecycleCounts::copyAssign)  return copyAssign;
+            if (field == &LifecycleCounts::moveAssign)  return moveAssign;
+            if (field == &LifecycleCounts::heapBytes)   return heapBytes;
+            return dtor;
+        }
+    };
+
+    static AtomicCounts & Global() {
+        static AtomicCounts counts;
+        return counts;
+    }
+    static LifecycleCounts & Local() {
+        thread_local LifecycleCounts counts;
+        return counts;
+    }
+    static void Count(long long LifecycleCounts::*field, long long heapBytes = 0) {
+        Global()[field].fetch_add(1, std::memory_order_relaxed);
+        Local().*field += 1;
+        if (heapBytes) {
+            Global().heapBytes.fetch_add(heapBytes, std::memory_order_relaxed);
+            Local().heapBytes += heapBytes;
+        }
+    }
+
+    T m_Value;
+};
+
+// -----------------------------------------------------------
+// Scoped report: snapshot at construction, difference on Delta()/destruction
+template <typename T>
+class LifecycleScope {
+public:
+    explicit LifecycleScope(std::string name, bool printOnExit = true)
+        : m_Name(std::move(name)), m_Start(Tracked<T>::Totals()), m_Print(printOnExit) {}
+    ~LifecycleScope() {
+        if (m_Print) {
+            std::cout << "  " << std::left << std::setw(38) << m_Name << std::right
+                      << Delta() << std::endl;
+        }
+    }
+    LifecycleCounts Delta() const { return Tracked<T>::Totals() - m_Start; }
+private:
+    std::string m_Name;
+    LifecycleCounts m_Start;
+    bool m_Print;
+};
+
+// -----------------------------------------------------------
+// Tiny check helper: a failed expectation makes main() return 1
+int g_Failures = 0;
+
+void Check(bool ok, const std::string &what) {
+    std::cout << (ok ? "  [PASS] " : "  [FAIL] ") << what << std::endl;
+    if (!ok) ++g_Failures;
+}
+
+// -----------------------------------------------------------
+// The file name from 2_Thread_pass_arguments.cpp, now with a real payload
+using String = Tracked<std::string>;
+
+void DownloadByValue(String fileName) { (void)fileName.get().size(); }
+void DownloadByRef(String &fileName) { (void)fileName.get().size(); }
+int  DownloadCount(String fileName) { return static_cast<int>(fileName.get().size()); }
+
+int main() {
+    const std::string PATH(200, 'x');     // long enough to defeat SSO
+
+    std::cout << "[main] thread launch paths\n";
+
+    // Step 1: std::thread + lvalue → the thread gets its own COPY (by design)
+    {
+        String file(PATH);
+        LifecycleScope<std::string> scope("std::thread(f, lvalue)");
+        std::thread t(DownloadByValue, file);
+        t.join();
+        Check(scope.Delta().Copies() == 1, "lvalue argument is copied exactly once");
+    }
+
+    // Step 2: std::thread + std::move → zero copies
+    {
+        String file(PATH);
+        LifecycleScope<std::string> scope("std::thread(f, std::move)");
+        std::thread t(DownloadByValue, std::move(file));
+        t.join();
+        Check(scope.Delta().Copies() == 0, "moved argument: zero copies");
+    }
+
+    // Step 3: std::ref → no copy, no move
+    {
+        String file(PATH);
+        LifecycleScope<std::string> scope("std::thread(f, std::ref)");
+        std::thread t(DownloadByRef, std::ref(file));
+        t.join();
+        Check(scope.Delta().Copies() == 0 && scope.Delta().Moves() == 0, "std::ref: no copy, no move");
+    }
+
+    // Step 4: std::async + std::move
+    {
+        String file(PATH);
+        LifecycleScope<std::string> scope("std::async(async, f, std::move)");
+        auto result = std::async(std::launch::async, DownloadCount, std::move(file));
+        result.get();
+        Check(scope.Delta().Copies() == 0, "std::async moved argument: zero copies");
+    }
+
+    // Step 5: std::packaged_task run on a thread
+    {
+        String file(PATH);
+        LifecycleScope<std::string> scope("packaged_task + thread, std::move");
+        std::packaged_task<int(String)> task{DownloadCount};
+        auto result = task.get_future();
+        std::thread t{std::move(task), std::move(file)};
+        result.get();
+        t.join();
+        Check(scope.Delta().Copies() == 0, "packaged_task moved argument: zero copies");
+    }
+
+    // Step 6: a classic regression - storing the job in a std::function copies the capture
+    {
+        String file(PATH);
+        LifecycleScope<std::string> scope("std::function<void()> job, thread");
+        std::function<void()> job = [file = std::move(file)] { (void)file.get().size(); };
+        std::thread t(job);           // std::function is copyable → thread copies it
+        t.join();
+        Check(scope.Delta().Copies() >= 1, "std::function job IS copied (what the checks catch)");
+    }
+
+    // Step 7: who made the copies? per-thread counters
+    {
+        String file(PATH);
+        LifecycleCounts before = Tracked<std::string>::ThisThread();
+        LifecycleCounts inWorker;
+        std::thread t([&inWorker](String s) {
+            inWorker = Tracked<std::string>::ThisThread();
+            (void)s;
+        }, file);
+        t.join();
+        LifecycleCounts inMain = Tracked<std::string>::ThisThread() - before;
+        std::cout << "  copies on main thread: " << inMain.Copies()
+                  << ", on worker thread: " << inWorker.Copies() << std::endl;
+        Check(inMain.Copies() == 1 && inWorker.Copies() == 0,
+              "std::thread copies the argument on the CALLING thread");
+    }
+
+    // Step 8: benchmark - 20000 launches, copies vs moves, guarded by the counters
+    std::cout << "\n[main] 20000 std::async launches with a 64KB payload\n";
+    const int LAUNCHES = 20000;
+    const std::string BIG(64 * 1024, 'y');
+    for (bool moveIt : {false, true}) {
+        LifecycleScope<std::string> scope(moveIt ? "moved" : "copied", false);
+        auto begin = std::chrono::steady_clock::now();
+        for (int i = 0; i < LAUNCHES; ++i) {
+            String file(BIG);
+            auto result = moveIt ? std::async(std::launch::async, DownloadCount, std::move(file))
+                                 : std::async(std::launch::async, DownloadCount, file);
+            result.get();
+        }
+        double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count();
+        LifecycleCounts d = scope.Delta();
+        std::cout << "  " << (moveIt ? "moved " : "copied") << "  copies=" << std::setw(6) << d.Copies()
+                  << "  " << std::fixed << std::setprecision(2) << us / LAUNCHES << " us/launch, "
+                  << d.heapBytes / LAUNCHES << " heap bytes copied/launch" << std::endl;
+        if (moveIt) Check(d.Copies() == 0, "moved launches stay copy-free");
+    }
+
+    std::cout << "\n[main] " << (g_Failures ? "FAILED" : "all checks passed") << std::endl;
+    return g_Failures ? 1 : 0;
+}
+
+/* ------------------------------------------------------------------
+THEORY & KEY POINTS: Argument lifecycle
+
+1. std::thread / std::async store DECAYED copies of their arguments:
+   - lvalue argument   → copy constructed into the thread's storage.
+   - rvalue (std::move)→ move constructed, no copy.
+   - std::ref(x)       → only a reference_wrapper is stored, no copy/move.
+   - The copy/move happens on the CALLING thread, before the new thread starts,
+     so dangling references to locals are not a problem for copied values.
+
+2. Then the stored value is passed to the function:
+   - by value parameter → one more MOVE (the stored value is an rvalue).
+   - by reference       → must use std::ref, otherwise it does not compile.
+
+3. Why count instead of print?
+   - Printing "String(const String&)" (2_Thread_pass_arguments.cpp) is nice
+     for learning but impossible to check automatically.
+   - Counters + a scope give numbers: "copies == 0" becomes a test that
+     fails the run when somebody adds a copy by accident.
+
+4. Per type and per thread:
+   - Global atomic counters → totals across all threads for a type.
+   - thread_local counters   → which thread paid for the copy.
+
+5. Common accidental copies:
+   - Capturing by value in a lambda stored in std::function (copyable!).
+   - Passing an lvalue where a std::move was intended.
+   - Returning a member instead of moving it out.
+   - Missing noexcept on a move constructor → std::vector copies on growth.
+
+------------------------------------------------------------------
+
+💡 Memory Tip / Analogy
+	•	Copy = photocopying the whole book for the new thread.
+	•	Move = handing the book over; you don't have it any more.
+	•	std::ref = telling the thread which shelf the book is on.
+	•	Tracked<T> = a librarian that writes down every photocopy made.
+
+*/
@@ -0,0 +1,646 @@
+// 18_Thread_shared_memory_ring_ipc.cpp
+// clang++ -std=c++17 -O2 -pthread 18_Thread_shared_memory_ring_ipc.cpp -o a; ./a
+//   ./a consumer /ring_demo      (terminal 1)  - two unrelated processes via shm_open
+//   ./a producer /ring_demo      (terminal 2)
+// @author :  DhiraxD
+// @brief  : Producer/consumer ACROSS processes (9_Thread_condition_variable.cpp and
+//           10_Thread_ConditionVariable_example.cpp only work inside one process)
+//           - ring buffer in shared memory (memfd_create or shm_open + mmap)
+//           - many producers / one consumer, variable-length records
+//           - process-shared futex wakeups instead of std::condition_variable
+//           - detects a crashed peer instead of waiting forever
+//           Compared with a Unix domain socket. (Linux only: futex, memfd, /proc)
+// References:
+// https://man7.org/linux/man-pages/man2/memfd_create.2.html
+// https://man7.org/linux/man-pages/man3/shm_open.3.html
+// https://man7.org/linux/man-pages/man2/futex.2.html
+// https://man7.org/linux/man-pages/man7/unix.7.html
+// https://en.cppreference.com/w/cpp/atomic/atomic/is_always_lock_free
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <climits>
+#include <fstream>
+#include <stdexcept>
+#include <system_error>
+#include <new>
+#include <thread>
+
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+
+// -----------------------------------------------------------
+// Only address-free (lock-free) atomics may live in memory shared between
+// processes - a lock-based std::atomic would use a lock private to one process.
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "need lock-free 64-bit atomics");
+static_assert(std::atomic<std::uint32_t>::is_always_lock_free, "need lock-free 32-bit atomics");
+
+[[noreturn]] void ThrowErrno(const char *what) {
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+// Futex WITHOUT FUTEX_PRIVATE_FLAG → works across processes on shared memory
+int FutexWait(std::atomic<std::uint32_t> *addr, std::uint32_t expected, std::chrono::milliseconds timeout) {
+    timespec ts{static_cast<time_t>(timeout.count() / 1000), static_cast<long>(timeout.count() % 1000) * 1000000};
+    return static_cast<int>(::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(addr), FUTEX_WAIT,
+                                      expected, &ts, nullptr, 0));
+}
+
+void FutexWake(std::atomic<std::uint32_t> *addr, int count) {
+    ::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(addr), FUTEX_WAKE, count, nullptr, nullptr, 0);
+}
+
+// A pid is "alive" if it exists and is not a zombie waiting to be reaped
+bool IsAlive(pid_t pid) {
+    if (pid <= 0) return false;
+    if (::kill(pid, 0) != 0 && errno == ESRCH) return false;
+    std::ifstream stat("/proc/" + std::to_string(pid) + "/stat");
+    std::string skip, state;
+    if (stat >> skip) {
+        // the comm field is "(name)" and may contain spaces → skip to the last ')'
+        std::string rest;
+        std::getline(stat, rest);
+        auto close = rest.rfind(')');
+        if (close != std::string::npos && close + 2 < rest.size()) state = rest.substr(close + 2, 1);
+    }
+    return state != "Z" && state != "X";
+}
+
+// -----------------------------------------------------------
+// Shared-memory layout:  [ RingControl | data bytes (capacity, power of 2) ]
+//
+// Records:  [ RecordHeader (8 bytes) | payload | pad to 8 ]
+// - Producers RESERVE space with a CAS on `reserve`, copy the payload, then
+//   COMMIT by storing the header word (length | COMMITTED) with release order.
+//   That makes it MPSC: reservations are ordered, commits may finish in any order.
+// - The consumer reads in order, waits for the COMMITTED bit, and zeroes what
+//   it consumed, so a stale header can never look committed after wrap-around.
+// - A record that does not fit before the end of the buffer is preceded by a
+//   PAD record that fills the tail; the record itself starts at offset 0.
+struct alignas(64) RingControl {
+    static constexpr std::uint32_t MAGIC = 0x52494E47;     // "RING"
+    static constexpr int MAX_PRODUCERS = 8;
+
+    std::uint32_t magic;
+    std::uint32_t capacity;
+
+    alignas(64) std::atomic<std::uint64_t> reserve;         // next free byte (producers)
+    alignas(64) std::atomic<std::uint64_t> head;            // next byte to read (consumer)
+
+    alignas(64) std::atomic<std::uint32_t> dataSeq;         // futex: "something was committed"
+    std::atomic<std::uint32_t> consumerWaiting;
+    alignas(64) std::atomic<std::uint32_t> spaceSeq;        // futex: "space was freed"
+    std::atomic<std::uint32_t> producersWaiting;
+
+    alignas(64) std::atomic<std::int32_t> consumerPid;      // 0 = not registered yet
+    std::atomic<std::int32_t> producerPids[MAX_PRODUCERS];  // 0 = free slot
+    std::atomic<std::uint32_t> producerRegistrations;       // ever registered (slots get cleared)
+};
+
+struct RecordHeader {
+    std::atomic<std::uint32_t> word;      // length | COMMITTED
+    std::uint32_t type;                   // DATA or PAD
+};
+static_assert(sizeof(RecordHeader) == 8, "header must stay 8 bytes");
+
+enum class Status { Ok, Timeout, PeerDead };
+
+class ShmRing {
+    static constexpr std::uint32_t COMMITTED = 0x80000000u;
+    static constexpr std::uint32_t DATA = 1, PAD = 2;
+    static constexpr auto WAIT_SLICE = std::chrono::milliseconds(100);
+
+public:
+    // Size of the shared mapping for `capacity` data bytes
+    static std::size_t MappingSize(std::uint32_t capacity) { return sizeof(RingControl) + capacity; }
+
+    // Formats a fresh mapping (exactly one side does this)
+    static ShmRing Create(void *memory, std::uint32_t capacity) {
+        if (capacity == 0 || (capacity & (capacity - 1)) != 0) {
+            throw std::invalid_argument("capacity must be a power of two");
+        }
+        auto *ctl = ::new (memory) RingControl{};
+        ctl->capacity = capacity;
+        std::memset(reinterpret_cast<char*>(ctl + 1), 0, capacity);
+        std::atomic_thread_fence(std::memory_order_release);
+        ctl->magic = RingControl::MAGIC;
+        return ShmRing(ctl);
+    }
+
+    // Attaches to a mapping formatted by Create() (possibly in another process)
+    static ShmRing Attach(void *memory) {
+        auto *ctl = static_cast<RingControl*>(memory);
+        if (ctl->magic != RingControl::MAGIC) throw std::runtime_error("not a ring");
+        return ShmRing(ctl);
+    }
+
+    // The parent may register a fork()ed consumer by pid right after fork(),
+    // so producers never see "no consumer" while the child is starting up
+    void RegisterConsumer(pid_t pid = ::getpid()) { m_Ctl->consumerPid.store(pid); }
+    void RegisterProducer() {
+        for (auto &slot : m_Ctl->producerPids) {
+            std::int32_t expected = 0;
+            if (slot.compare_exchange_strong(expected, ::getpid())) {
+                m_Ctl->producerRegistrations.fetch_add(1);
+                return;
+            }
+        }
+        throw std::runtime_error("too many producers");
+    }
+    // Clean exit: free the slot, so this pid no longer counts as a dead producer
+    void UnregisterProducer() {
+        for (auto &slot : m_Ctl->producerPids) {
+            std::int32_t expected = ::getpid();
+            if (slot.compare_exchange_strong(expected, 0)) return;
+        }
+    }
+
+    std::uint32_t MaxRecord() const { return m_Ctl->capacity / 2 - sizeof(RecordHeader); }
+
+    // ---------------- producer side (any number of processes/threads) ----------------
+    Status Write(const void *payload, std::uint32_t len, std::chrono::milliseconds timeout) {
+        if (len > MaxRecord()) throw std::invalid_argument("record too large for ring");
+        const std::uint64_t need = Align8(sizeof(RecordHeader) + len);
+        const std::uint64_t cap = m_Ctl->capacity;
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+
+        std::uint64_t pos, total, offset;
+        while (true) {
+            pos = m_Ctl->reserve.load(std::memory_order_relaxed);
+            offset = pos & (cap - 1);
+            const std::uint64_t tillEnd = cap - offset;
+            total = need <= tillEnd ? need : tillEnd + need;
+            if (pos + total - m_Ctl->head.load(std::memory_order_acquire) <= cap) {
+                if (m_Ctl->reserve.compare_exchange_weak(pos, pos + total, std::memory_order_relaxed)) break;
+                continue;
+            }
+            // Ring full: sleep until the consumer frees space
+            Status s = WaitForSpace(pos, total, deadline);
+            if (s != Status::Ok) return s;
+        }
+
+        if (total != need) {    // pad the tail, record starts at offset 0
+            Commit(offset, static_cast<std::uint32_t>(cap - offset - sizeof(RecordHeader)), PAD);
+            offset = 0;
+        }
+        std::memcpy(Data() + offset + sizeof(RecordHeader), payload, len);
+        Commit(offset, len, DATA);
+
+        m_Ctl->dataSeq.fetch_add(1, std::memory_order_seq_cst);
+        if (m_Ctl->consumerWaiting.load(std::memory_order_seq_cst)) {
+            FutexWake(&m_Ctl->dataSeq, 1);
+        }
+        return Status::Ok;
+    }
+
+    // ---------------- consumer side (exactly one) ----------------
+    // Calls fn(const char *payload, uint32_t len) for one record, in place (no copy)
+    template <typename Fn>
+    Status Read(Fn &&fn, std::chrono::milliseconds timeout) {
+        const std::uint64_t cap = m_Ctl->capacity;
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (true) {
+            const std::uint64_t head = m_Ctl->head.load(std::memory_order_relaxed);
+            const std::uint64_t offset = head & (cap - 1);
+            auto *hdr = Header(offset);
+            const std::uint32_t word = hdr->word.load(std::memory_order_acquire);
+            if (!(word & COMMITTED)) {
+                Status s = WaitForData(hdr, deadline);
+                if (s != Status::Ok) return s;
+                continue;
+            }
+            const std::uint32_t len = word & ~COMMITTED;
+            const std::uint64_t size = Align8(sizeof(RecordHeader) + len);
+            const bool isData = hdr->type == DATA;
+            if (isData) {
+                fn(Data() + offset + sizeof(RecordHeader), len);
+            }
+            std::memset(Data() + offset, 0, size);                 // un-commit for the next lap
+            m_Ctl->head.store(head + size, std::memory_order_release);
+            m_Ctl->spaceSeq.fetch_add(1, std::memory_order_seq_cst);
+            if (m_Ctl->producersWaiting.load(std::memory_order_seq_cst)) {
+                FutexWake(&m_Ctl->spaceSeq, INT_MAX);
+            }
+            if (isData) return Status::Ok;
+        }
+    }
+
+private:
+    explicit ShmRing(RingControl *ctl) : m_Ctl(ctl) {}
+
+    static std::uint64_t Align8(std::uint64_t n) { return (n + 7) & ~std::uint64_t(7); }
+    char * Data() const { return reinterpret_cast<char*>(m_Ctl + 1); }
+    RecordHeader * Header(std::uint64_t offset) const {
+        return reinterpret_cast<RecordHeader*>(Data() + offset);
+    }
+
+    void Commit(std::uint64_t offset, std::uint32_t len, std::uint32_t type) {
+        auto *hdr = Header(offset);
+        hdr->type = type;
+        hdr->word.store(len | COMMITTED, std::memory_order_release);
+    }
+
+    bool AnyProducerDead() const {
+        for (auto &slot : m_Ctl->producerPids) {
+            std::int32_t pid = slot.load();
+            if (pid != 0 && !IsAlive(pid)) return true;
+        }
+        return false;
+    }
+    // "All gone" only counts once somebody registered - a consumer may start first
+    bool AllProducersGone() const {
+        if (m_Ctl->producerRegistrations.load() == 0) return false;
+        for (auto &slot : m_Ctl->producerPids) {
+            std::int32_t pid = slot.load();
+            if (pid != 0 && IsAlive(pid)) return false;
+        }
+        return true;
+    }
+
+    // Same protocol as condition_variable::wait with a predicate, but on a futex:
+    // announce "I'm waiting", re-check, then sleep only if the sequence is unchanged.
+    Status WaitForData(RecordHeader *hdr, std::chrono::steady_clock::time_point deadline) {
+        for (int spin = 0; spin < 64; ++spin) {
+            if (hdr->word.load(std::memory_order_acquire) & COMMITTED) return Status::Ok;
+            std::this_thread::yield();
+        }
+        std::uint32_t seq = m_Ctl->dataSeq.load(std::memory_order_seq_cst);
+        m_Ctl->consumerWaiting.store(1, std::memory_order_seq_cst);
+        if (!(hdr->word.load(std::memory_order_acquire) & COMMITTED)) {
+            FutexWait(&m_Ctl->dataSeq, seq, WAIT_SLICE);
+        }
+        m_Ctl->consumerWaiting.store(0, std::memory_order_relaxed);
+        if (hdr->word.load(std::memory_order_acquire) & COMMITTED) return Status::Ok;
+
+        // Nothing yet: a producer died mid-record, or every producer is gone?
+        const bool reservedButNotCommitted =
+            m_Ctl->reserve.load() != m_Ctl->head.load(std::memory_order_relaxed);
+        if ((reservedButNotCommitted && AnyProducerDead()) ||
+            (!reservedButNotCommitted && AllProducersGone())) {
+            return Status::PeerDead;
+        }
+        return std::chrono::steady_clock::now() >= deadline ? Status::Timeout : Status::Ok;
+    }
+
+    Status WaitForSpace(std::uint64_t pos, std::uint64_t total, std::chrono::steady_clock::time_point deadline) {
+        std::uint32_t seq = m_Ctl->spaceSeq.load(std::memory_order_seq_cst);
+        m_Ctl->producersWaiting.fetch_add(1, std::memory_order_seq_cst);
+        if (pos + total - m_Ctl->head.load(std::memory_order_seq_cst) > m_Ctl->capacity) {
+            FutexWait(&m_Ctl->spaceSeq, seq, WAIT_SLICE);
+        }
+        m_Ctl->producersWaiting.fetch_sub(1, std::memory_order_relaxed);
+        const std::int32_t consumer = m_Ctl->consumerPid.load();
+        if (consumer != 0 && !IsAlive(consumer)) return Status::PeerDead;     // 0: not started yet, keep waiting
+        return std::chrono::steady_clock::now() >= deadline ? Status::Timeout : Status::Ok;
+    }
+
+    RingControl *m_Ctl;
+};
+
+// -----------------------------------------------------------
+// Anonymous shared memory for a parent and its fork()ed children
+void * MapAnonymousShared(std::size_t size) {
+    int fd = static_cast<int>(::syscall(SYS_memfd_create, "shm_ring", 0));
+    if (fd < 0) ThrowErrno("memfd_create");
+    if (::ftruncate(fd, static_cast<off_t>(size)) != 0) ThrowErrno("ftruncate");
+    void *p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);                          // the mapping keeps the memory alive
+    if (p == MAP_FAILED) ThrowErrno("mmap");
+    return p;
+}
+
+// Named shared memory for unrelated processes
+void * MapNamedShared(const std::string &name, std::size_t size, bool create) {
+    int fd = ::shm_open(name.c_str(), create ? (O_CREAT | O_RDWR | O_TRUNC) : O_RDWR, 0600);
+    if (fd < 0) ThrowErrno("shm_open");
+    if (create && ::ftruncate(fd, static_cast<off_t>(size)) != 0) ThrowErrno("ftruncate");
+    void *p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) ThrowErrno("mmap");
+    return p;
+}
+
+const std::uint32_t RING_BYTES = 4u << 20;          // 4MB of record space
+const auto TIMEOUT = std::chrono::seconds(5);
+
+// Runs `child` in a forked process, returns its pid
+template <typename Fn>
+pid_t Spawn(Fn child) {
+    pid_t pid = ::fork();
+    if (pid < 0) ThrowErrno("fork");
+    if (pid == 0) {
+        int rc = 0;
+        try { rc = child(); } catch (const std::exception &ex) { std::cerr << ex.what() << std::endl; rc = 2; }
+        ::_exit(rc);
+    }
+    return pid;
+}
+
+int WaitChild(pid_t pid) {
+    int status = 0;
+    ::waitpid(pid, &status, 0);
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+// -----------------------------------------------------------
+// Benchmark 1: one-way throughput (messages/sec)
+double ShmThroughput(std::uint32_t msgSize, long long count) {
+    void *mem = MapAnonymousShared(ShmRing::MappingSize(RING_BYTES));
+    ShmRing ring = ShmRing::Create(mem, RING_BYTES);
+    ring.RegisterProducer();
+
+    auto begin = std::chrono::steady_clock::now();
+    pid_t consumer = Spawn([&] {
+        long long got = 0, bytes = 0;
+        while (got < count) {
+            if (ring.Read([&](const char *, std::uint32_t len) { bytes += len; }, TIMEOUT) != Status::Ok) return 1;
+            ++got;
+        }
+        return bytes == count * msgSize ? 0 : 1;
+    });
+    ring.RegisterConsumer(consumer);
+    std::vector<char> msg(msgSize, 'x');
+    for (long long i = 0; i < count; ++i) {
+        std::memcpy(msg.data(), &i, std::min<std::size_t>(sizeof(i), msgSize));
+        if (ring.Write(msg.data(), msgSize, TIMEOUT) != Status::Ok) break;
+    }
+    int rc = WaitChild(consumer);
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    ::munmap(mem, ShmRing::MappingSize(RING_BYTES));
+    return rc == 0 ? count / secs : -1;
+}
+
+bool WriteAll(int fd, const char *p, std::size_t n) {
+    while (n > 0) {
+        ssize_t w = ::send(fd, p, n, MSG_NOSIGNAL);     // dead peer: EPIPE, not SIGPIPE
+        if (w < 0 && errno == EINTR) continue;
+        if (w <= 0) return false;
+        p += w; n -= static_cast<std::size_t>(w);
+    }
+    return true;
+}
+
+bool ReadAll(int fd, char *p, std::size_t n) {
+    while (n > 0) {
+        ssize_t r = ::read(fd, p, n);
+        if (r < 0 && errno == EINTR) continue;
+        if (r <= 0) return false;
+        p += r; n -= static_cast<std::size_t>(r);
+    }
+    return true;
+}
+
+double SocketThroughput(std::uint32_t msgSize, long long count) {
+    int sv[2];
+    if (::socketpair(AF_UNIX, SOCK_STREAM, 0, sv) != 0) ThrowErrno("socketpair");
+    auto begin = std::chrono::steady_clock::now();
+    pid_t consumer = Spawn([&] {
+        ::close(sv[0]);
+        std::vector<char> buf(msgSize);
+        for (long long i = 0; i < count; ++i) {
+            std::uint32_t len;
+            if (!ReadAll(sv[1], reinterpret_cast<char*>(&len), sizeof(len)) ||
+                !ReadAll(sv[1], buf.data(), len)) return 1;
+        }
+        return 0;
+    });
+    ::close(sv[1]);
+    std::vector<char> frame(sizeof(std::uint32_t) + msgSize, 'x');
+    std::memcpy(frame.data(), &msgSize, sizeof(msgSize));
+    for (long long i = 0; i < count; ++i) {
+        if (!WriteAll(sv[0], frame.data(), frame.size())) break;     // one send() per message
+    }
+    int rc = WaitChild(consumer);
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    ::close(sv[0]);
+    return rc == 0 ? count / secs : -1;
+}
+
+// Benchmark 2: ping-pong round trip (latency); -1 if the echo child died or a call timed out
+double ShmRoundTripUs(int iterations) {
+    void *mem = MapAnonymousShared(2 * ShmRing::MappingSize(RING_BYTES));
+    ShmRing ping = ShmRing::Create(mem, RING_BYTES);
+    ShmRing pong = ShmRing::Create(static_cast<char*>(mem) + ShmRing::MappingSize(RING_BYTES), RING_BYTES);
+    ping.RegisterProducer();
+    pong.RegisterConsumer();
+    pid_t echo = Spawn([&] {
+        pong.RegisterProducer();
+        for (int i = 0; i < iterations; ++i) {
+            char buf[64];
+            std::uint32_t n = 0;
+            if (ping.Read([&](const char *p, std::uint32_t len) { std::memcpy(buf, p, n = len); }, TIMEOUT) != Status::Ok) return 1;
+            if (pong.Write(buf, n, TIMEOUT) != Status::Ok) return 1;
+        }
+        return 0;
+    });
+    ping.RegisterConsumer(echo);
+    char msg[64] = "ping";
+    bool ok = true;
+    auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations && ok; ++i) {
+        ok = ping.Write(msg, sizeof(msg), TIMEOUT) == Status::Ok &&
+             pong.Read([](const char *, std::uint32_t) {}, TIMEOUT) == Status::Ok;
+    }
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count();
+    if (!ok) ::kill(echo, SIGKILL);         // may still be waiting for a ping that never comes
+    int rc = WaitChild(echo);
+    ::munmap(mem, 2 * ShmRing::MappingSize(RING_BYTES));
+    return ok && rc == 0 ? us / iterations : -1;
+}
+
+double SocketRoundTripUs(int iterations) {
+    int sv[2];
+    if (::socketpair(AF_UNIX, SOCK_STREAM, 0, sv) != 0) ThrowErrno("socketpair");
+    pid_t echo = Spawn([&] {
+        ::close(sv[0]);
+        char buf[64];
+        for (int i = 0; i < iterations; ++i) {
+            if (!ReadAll(sv[1], buf, sizeof(buf)) || !WriteAll(sv[1], buf, sizeof(buf))) return 1;
+        }
+        return 0;
+    });
+    ::close(sv[1]);
+    char msg[64] = "ping";
+    bool ok = true;
+    auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations && ok; ++i) {
+        ok = WriteAll(sv[0], msg, sizeof(msg)) && ReadAll(sv[0], msg, sizeof(msg));
+    }
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count();
+    ::close(sv[0]);                         // EOF for the echo child if we stopped early
+    int rc = WaitChild(echo);
+    return ok && rc == 0 ? us / iterations : -1;
+}
+
+// -----------------------------------------------------------
+// Two unrelated processes: ./a consumer /name   and   ./a producer /name
+int RunNamed(const std::string &role, const std::string &name) {
+    const std::size_t size = ShmRing::MappingSize(RING_BYTES);
+    if (role == "consumer") {
+        ShmRing ring = ShmRing::Create(MapNamedShared(name, size, true), RING_BYTES);
+        ring.RegisterConsumer();
+        std::cout << "[Consumer] waiting on " << name << std::endl;
+        while (true) {
+            Status s = ring.Read([](const char *p, std::uint32_t len) {
+                std::cout << "[Consumer] Consumed: " << std::string(p, len) << std::endl;
+            }, std::chrono::seconds(60));
+            if (s == Status::PeerDead) { std::cout << "[Consumer] producer gone" << std::endl; break; }
+            if (s == Status::Timeout) break;
+        }
+        ::shm_unlink(name.c_str());
+        return 0;
+    }
+    ShmRing ring = ShmRing::Attach(MapNamedShared(name, size, false));
+    ring.RegisterProducer();
+    for (int i = 1; i <= 5; ++i) {
+        std::string item = "item " + std::to_string(i) + " from pid " + std::to_string(::getpid());
+        ring.Write(item.data(), static_cast<std::uint32_t>(item.size()), TIMEOUT);
+        std::cout << "[Producer] Produced: " << item << std::endl;
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    ring.UnregisterProducer();
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc == 3) {
+        return RunNamed(argv[1], argv[2]);
+    }
+
+    // Step 1: crash detection - the producer process dies after 3 records
+    {
+        void *mem = MapAnonymousShared(ShmRing::MappingSize(RING_BYTES));
+        ShmRing ring = ShmRing::Create(mem, RING_BYTES);
+        ring.RegisterConsumer();
+        pid_t producer = Spawn([&] {
+            ring.RegisterProducer();
+            for (int i = 1; i <= 3; ++i) {
+                std::string item = "record " + std::to_string(i);
+                ring.Write(item.data(), static_cast<std::uint32_t>(item.size()), TIMEOUT);
+            }
+            ::raise(SIGKILL);           // simulate a crash, no clean shutdown
+            return 0;
+        });
+        while (true) {
+            Status s = ring.Read([](const char *p, std::uint32_t len) {
+                std::cout << "[Consumer] Consumed: " << std::string(p, len) << std::endl;
+            }, TIMEOUT);
+            if (s == Status::PeerDead) { std::cout << "[Consumer] detected dead producer" << std::endl; break; }
+            if (s == Status::Timeout)  { std::cout << "[Consumer] timeout" << std::endl; break; }
+        }
+        WaitChild(producer);
+        ::munmap(mem, ShmRing::MappingSize(RING_BYTES));
+    }
+
+    // Step 2: MPSC - several producer processes finish at different times and
+    // unregister; the ones that exited must not look "dead" to the consumer
+    {
+        const int PRODUCERS = 4, EACH = 20000;
+        void *mem = MapAnonymousShared(ShmRing::MappingSize(RING_BYTES));
+        ShmRing ring = ShmRing::Create(mem, RING_BYTES);
+        ring.RegisterConsumer();
+        std::vector<pid_t> producers;
+        for (int p = 0; p < PRODUCERS; ++p) {
+            producers.push_back(Spawn([&ring, p] {
+                ring.RegisterProducer();
+                for (int i = 0; i < EACH * (p + 1) / PRODUCERS; ++i) {
+                    if (ring.Write(&i, sizeof(i), TIMEOUT) != Status::Ok) return 1;
+                }
+                ring.UnregisterProducer();
+                return 0;
+            }));
+        }
+        long long expected = 0, got = 0;
+        for (int p = 0; p < PRODUCERS; ++p) expected += EACH * (p + 1) / PRODUCERS;
+        Status s = Status::Ok;
+        while (got < expected && (s = ring.Read([](const char *, std::uint32_t) {}, TIMEOUT)) == Status::Ok) ++got;
+        int failed = 0;
+        for (pid_t pid : producers) failed += WaitChild(pid) != 0;
+        std::cout << "[main] MPSC: " << got << "/" << expected << " records from " << PRODUCERS
+                  << " producers, failed producers: " << failed
+                  << (s == Status::Ok ? "" : s == Status::Timeout ? " (timeout)" : " (peer dead)") << std::endl;
+        ::munmap(mem, ShmRing::MappingSize(RING_BYTES));
+    }
+
+    // Step 3: throughput
+    const long long COUNT = 1000000;
+    std::cout << "\none-way throughput, " << COUNT << " messages (Mmsg/s)\n"
+              << std::setw(10) << "msg size" << std::setw(14) << "shm ring" << std::setw(14) << "unix socket" << std::endl;
+    for (std::uint32_t size : {16u, 64u, 256u, 1024u, 4096u}) {
+        std::cout << std::setw(9) << size << "B"
+                  << std::setw(14) << std::fixed << std::setprecision(2) << ShmThroughput(size, COUNT) / 1e6
+                  << std::setw(14) << SocketThroughput(size, COUNT) / 1e6 << std::endl;
+    }
+
+    // Step 4: latency
+    const int ROUND_TRIPS = 20000;
+    std::cout << "\nping-pong, 64B, " << ROUND_TRIPS << " round trips\n"
+              << "  shm ring    : " << std::setprecision(2) << ShmRoundTripUs(ROUND_TRIPS) << " us/round trip\n"
+              << "  unix socket : " << SocketRoundTripUs(ROUND_TRIPS) << " us/round trip" << std::endl;
+
+    return 0;
+}
+
+/* ------------------------------------------------------------------
+THEORY & KEY POINTS: Shared-memory IPC
+
+1. Why not std::mutex / std::condition_variable?
+   - They live in one process. A second process has different memory.
+   - pthread mutexes CAN be process-shared (PTHREAD_PROCESS_SHARED), but
+     we only need lock-free atomics + futex, which work on any shared page.
+
+2. Getting shared memory:
+   - memfd_create + mmap(MAP_SHARED) → anonymous, inherited across fork().
+   - shm_open("/name") + mmap        → named, for unrelated processes.
+   - Store only lock-free atomics and plain bytes in it (no pointers! the
+     mapping address differs per process → use offsets).
+
+3. The ring (MPSC):
+   - reserve: producers CAS it forward to claim space.
+   - head: only the consumer moves it.
+   - Each record header has a COMMITTED bit, written LAST with release →
+     the consumer never sees half-written payloads.
+   - Variable-length records; a PAD record fills the end of the buffer when
+     a record doesn't fit there.
+   - Consumer zeroes consumed bytes → old headers can't look committed.
+
+4. Futex wakeups:
+   - Spinning wastes CPU, sleeping via syscall every message is slow.
+   - The waiter sets a "waiting" flag and sleeps on a sequence number.
+   - The waker only makes the FUTEX_WAKE syscall if someone is waiting.
+   - Without FUTEX_PRIVATE_FLAG the futex works across processes.
+
+5. Crash detection:
+   - A process can die while holding a reservation → its record is never
+     committed and a naive consumer waits forever.
+   - Waits are done in slices; after each slice we check the peers'
+     pids (kill(pid, 0) + zombie check in /proc) → Status::PeerDead.
+   - Producers that finish cleanly call UnregisterProducer(), so only a
+     real crash counts. An unregistered consumer (pid 0) is "not started
+     yet", not dead: the parent registers a fork()ed consumer by pid.
+
+6. vs Unix domain socket:
+   - Socket: 2 syscalls + 2 copies (user→kernel→user) per message.
+   - Ring: 0 syscalls when both sides are busy, 1 copy into the ring,
+     the consumer reads in place.
+
+------------------------------------------------------------------
+
+💡 Memory Tip / Analogy
+	•	Unix socket = sending letters through the post office (kernel) one by one.
+	•	Shared-memory ring = a shared whiteboard in the hallway; you only knock (futex) if the other person is asleep.
+	•	COMMITTED bit = the "done writing" tick you add after the message, never before.
+
+*/
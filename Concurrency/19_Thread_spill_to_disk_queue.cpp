@@ -0,0 +1,487 @@
+// 19_Thread_spill_to_disk_queue.cpp
+// clang++ -std=c++17 -O2 -pthread 19_Thread_spill_to_disk_queue.cpp -o a; ./a [spillDir] [seconds]
+// @author :  DhiraxD
+// @brief  : What if ProcessData() in 10_Thread_ConditionVariable_example.cpp
+//           falls behind? g_Data grows in RAM without limit. This queue keeps a
+//           BOUNDED in-memory window and spills the overflow to append-only
+//           segment files, reads them back (mmap) when the consumer catches up,
+//           keeps FIFO order and accounts for its memory.
+//           Benchmark: producer 10x faster than the consumer, RSS compared with
+//           the unbounded std::list. (POSIX / Linux: mmap, madvise, /proc)
+// References:
+// https://en.cppreference.com/w/cpp/thread/condition_variable
+// https://man7.org/linux/man-pages/man2/mmap.2.html
+// https://man7.org/linux/man-pages/man2/madvise.2.html
+// https://man7.org/linux/man-pages/man5/proc.5.html (VmRSS)
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <deque>
+#include <list>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <malloc.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// -----------------------------------------------------------
+[[noreturn]] void ThrowErrno(const std::string &what) {
+    throw std::runtime_error(what + ": " + std::strerror(errno));
+}
+
+// Resident set size of this process, from /proc/self/status
+long ReadRssKB() {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 6, "VmRSS:") == 0) return std::atol(line.c_str() + 6);
+    }
+    return 0;
+}
+
+// -----------------------------------------------------------
+// Hybrid queue of byte records.
+//
+//   Push ──► [ memory window (deque) ] ──► Pop
+//        └─► [ write buffer ] → seg_N.log ... seg_1.log ──► (mmap) ──┘
+//
+// FIFO rule: a record goes to memory ONLY while nothing is on disk. Once the
+// window is full every newer record is spilled, so the memory window always
+// holds the OLDEST records and the disk the newer ones. When the disk drains
+// completely the queue switches back to memory mode.
+//
+// Segment format: [uint32 length][bytes] repeated, append-only. A sealed
+// segment is read back through mmap and deleted once consumed.
+class SpillQueue {
+public:
+    struct Options {
+        std::string dir = "/tmp";
+        std::size_t memoryLimit = std::size_t(16) << 20;     // in-memory window
+        std::size_t segmentBytes = std::size_t(64) << 20;    // rotate after this
+        std::size_t writeBuffer = std::size_t(1) << 20;      // batch small writes
+        std::size_t diskLimit = std::size_t(8) << 30;        // Push blocks beyond this
+    };
+
+    struct Stats {
+        std::size_t memoryBytes = 0;        // records in the window (+ per-record overhead)
+        std::size_t peakMemoryBytes = 0;
+        std::size_t bufferedBytes = 0;      // write buffer + mapped, not yet released, read window
+        std::size_t diskBytes = 0;          // spilled and not yet consumed
+        std::size_t spilledRecords = 0;
+        std::size_t segmentsCreated = 0;
+    };
+
+    explicit SpillQueue(Options options) : m_Opt(std::move(options)) {
+        m_WriteBuf.reserve(m_Opt.writeBuffer);
+    }
+    ~SpillQueue() {
+        CloseWriter();
+        UnmapReader();
+        for (auto &seg : m_Sealed) ::unlink(seg.path.c_str());
+    }
+    SpillQueue(const SpillQueue&) = delete;
+    SpillQueue & operator=(const SpillQueue&) = delete;
+
+    void Push(const char *data, std::uint32_t len) {
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            const std::size_t cost = MemoryCost(len);
+            if (m_DiskRecords == 0 && m_Stats.memoryBytes + cost <= m_Opt.memoryLimit) {
+                m_Memory.emplace_back(data, len);
+                m_Stats.memoryBytes += cost;
+                m_Stats.peakMemoryBytes = std::max(m_Stats.peakMemoryBytes, m_Stats.memoryBytes);
+            } else {
+                m_NotFull.wait(lock, [this] { return m_Stats.diskBytes < m_Opt.diskLimit; });
+                Spill(data, len);
+            }
+        }
+        m_NotEmpty.notify_one();
+    }
+
+    void Push(const std::string &record) { Push(record.data(), static_cast<std::uint32_t>(record.size())); }
+
+    // Returns false once Close() was called and everything is drained
+    bool Pop(std::string &out) {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_NotEmpty.wait(lock, [this] { return !m_Memory.empty() || m_DiskRecords > 0 || m_Closed; });
+        if (!m_Memory.empty()) {                    // oldest records are always in memory
+            out = std::move(m_Memory.front());
+            m_Memory.pop_front();
+            m_Stats.memoryBytes -= MemoryCost(out.size());
+            return true;
+        }
+        if (m_DiskRecords == 0) return false;       // closed and drained
+        ReadFromDisk(out);
+        lock.unlock();
+        m_NotFull.notify_one();
+        return true;
+    }
+
+    void Close() {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Closed = true;
+        }
+        m_NotEmpty.notify_all();
+    }
+
+    Stats GetStats() const {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        Stats s = m_Stats;
+        s.bufferedBytes = m_WriteBuf.capacity() + (m_ReadOffset - m_ReadReleased);
+        return s;
+    }
+
+private:
+    struct Segment {
+        std::string path;
+        std::size_t bytes;
+    };
+
+    static constexpr std::size_t RELEASE_STEP = std::size_t(4) << 20;    // give read pages back every 4MB
+
+    // std::string header + heap block (small strings live inside the header)
+    static std::size_t MemoryCost(std::size_t len) {
+        return sizeof(std::string) + (len > 15 ? len + 1 : 0);
+    }
+
+    // ---------------- write side (called with m_Mutex held) ----------------
+    void Spill(const char *data, std::uint32_t len) {
+        if (m_WriteFd < 0) OpenWriter();
+        const char *lenBytes = reinterpret_cast<const char*>(&len);
+        m_WriteBuf.insert(m_WriteBuf.end(), lenBytes, lenBytes + sizeof(len));
+        m_WriteBuf.insert(m_WriteBuf.end(), data, data + len);
+        m_WriteBytes += sizeof(len) + len;
+        m_Stats.diskBytes += sizeof(len) + len;
+        ++m_Stats.spilledRecords;
+        ++m_DiskRecords;
+        if (m_WriteBuf.size() >= m_Opt.writeBuffer) FlushWriter();
+        if (m_WriteBytes >= m_Opt.segmentBytes) SealWriter();
+    }
+
+    void OpenWriter() {
+        std::ostringstream name;
+        name << m_Opt.dir << "/spill_" << ::getpid() << "_" << std::setw(6) << std::setfill('0')
+             << ++m_Stats.segmentsCreated << ".log";
+        m_WritePath = name.str();
+        m_WriteFd = ::open(m_WritePath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC, 0600);
+        if (m_WriteFd < 0) ThrowErrno("open " + m_WritePath);
+        m_WriteBytes = 0;
+    }
+
+    void FlushWriter() {
+        const char *p = m_WriteBuf.data();
+        std::size_t left = m_WriteBuf.size();
+        while (left > 0) {
+            ssize_t n = ::write(m_WriteFd, p, left);
+            if (n < 0 && errno == EINTR) continue;
+            if (n < 0) ThrowErrno("write " + m_WritePath);
+            p += n;
+            left -= static_cast<std::size_t>(n);
+        }
+        m_WriteBuf.clear();
+    }
+
+    // Finish the active segment and queue it for reading
+    void SealWriter() {
+        FlushWriter();
+        ::close(m_WriteFd);
+        m_WriteFd = -1;
+        m_Sealed.push_back({m_WritePath, m_WriteBytes});
+    }
+
+    void CloseWriter() {
+        if (m_WriteFd < 0) return;
+        ::close(m_WriteFd);
+        m_WriteFd = -1;
+        ::unlink(m_WritePath.c_str());
+    }
+
+    // ---------------- read side (called with m_Mutex held) ----------------
+    void ReadFromDisk(std::string &out) {
+        if (m_ReadBase == nullptr) {
+            // Consumer caught up with the writer: seal the active segment early
+            if (m_Sealed.empty()) SealWriter();
+            MapReader();
+        }
+        std::uint32_t len;
+        std::memcpy(&len, m_ReadBase + m_ReadOffset, sizeof(len));
+        out.assign(m_ReadBase + m_ReadOffset + sizeof(len), len);
+        m_ReadOffset += sizeof(len) + len;
+        m_Stats.diskBytes -= sizeof(len) + len;
+        --m_DiskRecords;
+
+        // Consumed pages are clean file pages: drop them so they leave our RSS
+        if (m_ReadOffset - m_ReadReleased >= RELEASE_STEP) {
+            std::size_t upTo = m_ReadOffset & ~(static_cast<std::size_t>(::sysconf(_SC_PAGESIZE)) - 1);
+            ::madvise(m_ReadBase + m_ReadReleased, upTo - m_ReadReleased, MADV_DONTNEED);
+            m_ReadReleased = upTo;
+        }
+        if (m_ReadOffset == m_ReadSize) {
+            UnmapReader();
+        }
+    }
+
+    void MapReader() {
+        Segment seg = m_Sealed.front();
+        m_Sealed.pop_front();
+        int fd = ::open(seg.path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) ThrowErrno("open " + seg.path);
+        void *p = ::mmap(nullptr, seg.bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) ThrowErrno("mmap " + seg.path);
+        ::madvise(p, seg.bytes, MADV_SEQUENTIAL);
+        ::unlink(seg.path.c_str());          // data stays reachable through the mapping
+        m_ReadBase = static_cast<char*>(p);
+        m_ReadSize = seg.bytes;
+        m_ReadOffset = m_ReadReleased = 0;
+    }
+
+    void UnmapReader() {
+        if (m_ReadBase == nullptr) return;
+        ::munmap(m_ReadBase, m_ReadSize);
+        m_ReadBase = nullptr;
+        m_ReadSize = m_ReadOffset = m_ReadReleased = 0;
+    }
+
+    Options m_Opt;
+    mutable std::mutex m_Mutex;
+    std::condition_variable m_NotEmpty, m_NotFull;
+    bool m_Closed = false;
+    Stats m_Stats;
+
+    std::deque<std::string> m_Memory;
+    std::size_t m_DiskRecords = 0;          // written (buffered or on disk) and not yet read
+
+    std::deque<Segment> m_Sealed;
+    int m_WriteFd = -1;
+    std::string m_WritePath;
+    std::size_t m_WriteBytes = 0;
+    std::vector<char> m_WriteBuf;
+
+    char *m_ReadBase = nullptr;             // PROT_READ mapping
+    std::size_t m_ReadSize = 0, m_ReadOffset = 0, m_ReadReleased = 0;
+};
+
+// -----------------------------------------------------------
+// The g_Data queue of 10_Thread_ConditionVariable_example.cpp, unbounded
+class ListQueue {
+public:
+    void Push(const std::string &record) {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Data.push_back(record);
+        }
+        m_CV.notify_one();
+    }
+    bool Pop(std::string &out) {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_CV.wait(lock, [this] { return !m_Data.empty() || m_Closed; });
+        if (m_Data.empty()) return false;
+        out = std::move(m_Data.front());
+        m_Data.pop_front();
+        return true;
+    }
+    void Close() {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Closed = true;
+        }
+        m_CV.notify_all();
+    }
+
+private:
+    std::list<std::string> m_Data;
+    bool m_Closed = false;
+    std::mutex m_Mutex;
+    std::condition_variable m_CV;
+};
+
+// -----------------------------------------------------------
+// Simulated per-record work (busy, so it costs CPU like real parsing does)
+void Work(std::chrono::nanoseconds duration) {
+    auto until = std::chrono::steady_clock::now() + duration;
+    while (std::chrono::steady_clock::now() < until) {}
+}
+
+const std::size_t RECORD_SIZE = 256;
+const auto PRODUCER_WORK = std::chrono::microseconds(1);
+const auto CONSUMER_WORK = PRODUCER_WORK * 10;               // consumer is 10x slower
+const long RSS_ABORT_KB = 1536 * 1024;                       // stop the baseline at 1.5GB
+
+struct RunResult {
+    long long pushed = 0, popped = 0;
+    double ingestSecs = 0, drainSecs = 0;
+    long peakRssKB = 0;
+    bool inOrder = true;
+};
+
+// Download(): push records for `seconds`. ProcessData(): 10x slower while the
+// download runs, then it "catches up" (no work) and drains the backlog.
+template <typename Queue>
+RunResult RunIngest(Queue &queue, double seconds) {
+    RunResult result;
+    const long baseRss = ReadRssKB();
+    std::atomic<bool> producing{true}, done{false};
+    std::atomic<long> peakRss{0};
+
+    std::thread monitor([&] {
+        while (!done.load()) {
+            peakRss.store(std::max(peakRss.load(), ReadRssKB() - baseRss));
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    });
+
+    std::thread consumer([&] {
+        std::string record;
+        long long expected = 0;
+        while (queue.Pop(record)) {
+            long long seq;
+            std::memcpy(&seq, record.data(), sizeof(seq));
+            if (seq != expected++) result.inOrder = false;
+            if (producing.load(std::memory_order_relaxed)) Work(CONSUMER_WORK);
+            ++result.popped;
+        }
+    });
+
+    auto begin = std::chrono::steady_clock::now();
+    auto until = begin + std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::duration<double>(seconds));
+    std::string record(RECORD_SIZE, 'x');
+    while (std::chrono::steady_clock::now() < until && peakRss.load() < RSS_ABORT_KB) {
+        for (int i = 0; i < 64; ++i) {
+            Work(PRODUCER_WORK);
+            std::memcpy(&record[0], &result.pushed, sizeof(result.pushed));
+            queue.Push(record);
+            ++result.pushed;
+        }
+    }
+    auto ingestEnd = std::chrono::steady_clock::now();
+    producing.store(false);
+    queue.Close();
+    consumer.join();
+    auto drainEnd = std::chrono::steady_clock::now();
+    done.store(true);
+    monitor.join();
+
+    result.ingestSecs = std::chrono::duration<double>(ingestEnd - begin).count();
+    result.drainSecs = std::chrono::duration<double>(drainEnd - ingestEnd).count();
+    result.peakRssKB = peakRss.load();
+    return result;
+}
+
+void PrintRun(const char *name, const RunResult &r) {
+    std::cout << std::left << std::setw(14) << name << std::right
+              << std::setw(10) << r.pushed
+              << std::setw(13) << std::fixed << std::setprecision(2) << r.pushed / r.ingestSecs / 1e6
+              << std::setw(14) << r.peakRssKB / 1024
+              << std::setw(12) << std::setprecision(2) << r.drainSecs
+              << std::setw(8) << (r.popped == r.pushed && r.inOrder ? "yes" : "NO") << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+    SpillQueue::Options options;
+    if (argc > 1) options.dir = argv[1];
+    const double seconds = argc > 2 ? std::atof(argv[2]) : 3.0;
+
+    // Step 1: small window, watch records move memory → disk → memory, in order
+    {
+        SpillQueue::Options small = options;
+        small.memoryLimit = 4 * (sizeof(std::string) + 64);     // room for 4 records
+        small.segmentBytes = 256;
+        SpillQueue queue(small);
+        for (int i = 0; i < 10; ++i) {
+            queue.Push("record " + std::to_string(i) + std::string(40, '.'));
+        }
+        SpillQueue::Stats s = queue.GetStats();
+        std::cout << "[Downloader] pushed 10: " << s.memoryBytes << " bytes in memory, "
+                  << s.spilledRecords << " spilled into " << s.segmentsCreated << " segments" << std::endl;
+        queue.Close();
+        std::string record;
+        while (queue.Pop(record)) {
+            std::cout << "[Processor] Processed " << record.substr(0, record.find('.')) << std::endl;
+        }
+    }
+
+    // Step 2: sustained ingest, consumer 10x slower
+    std::cout << "\n" << seconds << "s ingest of " << RECORD_SIZE << "B records, consumer 10x slower, window "
+              << (options.memoryLimit >> 20) << "MB, spill dir " << options.dir << "\n"
+              << std::left << std::setw(14) << "queue" << std::right
+              << std::setw(10) << "records" << std::setw(13) << "ingest M/s"
+              << std::setw(14) << "peak RSS MB" << std::setw(12) << "drain s" << std::setw(8) << "FIFO" << std::endl;
+    {
+        SpillQueue queue(options);
+        RunResult r = RunIngest(queue, seconds);
+        PrintRun("SpillQueue", r);
+        SpillQueue::Stats s = queue.GetStats();
+        std::cout << "    window peak " << (s.peakMemoryBytes >> 20) << "MB, spilled "
+                  << s.spilledRecords << " records into " << s.segmentsCreated << " segments" << std::endl;
+    }
+    ::malloc_trim(0);
+    {
+        ListQueue queue;
+        RunResult r = RunIngest(queue, seconds);
+        PrintRun("std::list", r);
+    }
+    ::malloc_trim(0);
+
+    return 0;
+}
+
+/* ------------------------------------------------------------------
+THEORY & KEY POINTS: Spill-to-disk queue
+
+1. The problem:
+   - Producer faster than consumer → the queue grows.
+   - In RAM it grows until the process is OOM-killed.
+   - Blocking the producer (bounded queue, 15_Thread_zero_copy_handoff.cpp)
+     is not always allowed: a network download can't be paused forever.
+
+2. Hybrid idea:
+   - Keep a bounded WINDOW in memory.
+   - Overflow goes to append-only SEGMENT files (sequential writes are the
+     cheapest thing a disk can do).
+   - Segments are read back in order and deleted once consumed.
+
+3. Keeping FIFO order:
+   - A record may go into memory only while the disk part is EMPTY.
+   - So memory always holds the oldest records, disk the newest.
+   - Pop: memory first, then disk. When the disk drains → back to memory mode.
+   - If the consumer catches up with the writer, the active segment is
+     sealed early so it can be read.
+
+4. Memory accounting:
+   - Window: payload + std::string overhead, checked against memoryLimit.
+   - Write buffer: fixed (1MB), batches small records into big writes.
+   - Read side: mmap'ed pages count toward RSS → consumed pages are dropped
+     with madvise(MADV_DONTNEED) every few MB.
+   - The page cache (kernel) still caches the files, but it is reclaimable
+     and not part of our RSS.
+
+5. Limits:
+   - Disk is finite too → diskLimit blocks the producer as a last resort.
+   - Records on disk are lost on a crash unless you fsync (not done here:
+     this is an overflow buffer, not a durable log).
+
+------------------------------------------------------------------
+
+💡 Memory Tip / Analogy
+	•	Memory window = your desk; segment files = boxes in the storage room.
+	•	When the desk is full, new papers go straight into boxes, in order.
+	•	You clear the desk first, then open the boxes oldest-first, and throw each box away when empty.
+
+*/
@@ -0,0 +1,377 @@
+// 20_Thread_task_group.cpp
+// clang++ -std=c++17 -O2 -pthread 20_Thread_task_group.cpp -o a; ./a
+// @author :  DhiraxD
+// @brief  : Structured concurrency: a TaskGroup ("nursery") instead of the
+//           loose t1/t2 threads + futures of 3_Thread_return_value_from_thread.cpp
+//           - Spawn() runs children on a thread pool
+//           - Wait() joins ALL of them; the waiting thread helps run queued tasks
+//           - the first exception cancels the siblings, all errors are collected
+//           - leaving the scope without Wait() cancels + waits, never std::terminate
+//           Compared with vector<future>.get() for 1M child tasks.
+// References:
+// https://en.cppreference.com/w/cpp/thread/future
+// https://en.cppreference.com/w/cpp/error/exception_ptr
+// https://vorpus.org/blog/notes-on-structured-concurrency-or-go-statement-considered-harmful/
+// https://oneapi-src.github.io/oneTBB/main/tbb_userguide/Task_Groups.html
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <functional>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <type_traits>
+
+// -----------------------------------------------------------
+// The mutex + condition_variable pool of 13_Thread_unique_task.cpp, plus
+// RunUntil(): a thread that has to wait runs queued tasks in the meantime.
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    explicit ThreadPool(unsigned workers) {
+        for (unsigned i = 0; i < workers; ++i) {
+            m_Workers.emplace_back([this] { RunUntil([] { return false; }); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Stop = true;
+        }
+        m_CV.notify_all();
+        for (auto &t : m_Workers) t.join();
+    }
+
+    void Submit(Task task) {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Queue.push_back(std::move(task));
+        }
+        m_CV.notify_one();
+    }
+
+    // Returns a future, like std::async
+    template <typename F, typename R = std::invoke_result_t<std::decay_t<F>&>>
+    std::future<R> Async(F &&f) {
+        auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(f));
+        std::future<R> result = task->get_future();
+        Submit([task] { (*task)(); });
+        return result;
+    }
+
+    // Runs queued tasks until done() is true (checked under the pool mutex).
+    // Workers take the OLDEST task (fair); a thread waiting in a group takes
+    // the NEWEST one - most likely its own child - so helping doesn't recurse
+    // into unrelated big subtrees and blow the stack.
+    template <typename Done>
+    void RunUntil(Done done, bool newestFirst = false) {
+        while (true) {
+            Task task;
+            {
+                std::unique_lock<std::mutex> lock(m_Mutex);
+                m_CV.wait(lock, [&] { return m_Stop || done() || !m_Queue.empty(); });
+                if (done()) return;
+                if (m_Queue.empty()) return;        // stop requested and drained
+                if (newestFirst) {
+                    task = std::move(m_Queue.back());
+                    m_Queue.pop_back();
+                } else {
+                    task = std::move(m_Queue.front());
+                    m_Queue.pop_front();
+                }
+            }
+            task();
+        }
+    }
+
+    // Wakes threads parked in RunUntil() so they re-check their predicate.
+    // Taking the mutex orders this after their check → no lost wake-up.
+    void NotifyAll() {
+        { std::lock_guard<std::mutex> lock(m_Mutex); }
+        m_CV.notify_all();
+    }
+
+private:
+    std::mutex m_Mutex;
+    std::condition_variable m_CV;
+    std::deque<Task> m_Queue;
+    bool m_Stop = false;
+    std::vector<std::thread> m_Workers;
+};
+
+// -----------------------------------------------------------
+// Thrown by TaskGroup::Wait(): every exception of every failed child
+class TaskGroupError : public std::exception {
+public:
+    explicit TaskGroupError(std::vector<std::exception_ptr> errors) : m_Errors(std::move(errors)) {
+        m_What = std::to_string(m_Errors.size()) + " task(s) failed";
+        try {
+            std::rethrow_exception(m_Errors.front());
+        } catch (const std::exception &ex) {
+            m_What += ", first: " + std::string(ex.what());
+        } catch (...) {
+        }
+    }
+    const char * what() const noexcept override { return m_What.c_str(); }
+    const std::vector<std::exception_ptr> & Errors() const { return m_Errors; }
+
+private:
+    std::vector<std::exception_ptr> m_Errors;
+    std::string m_What;
+};
+
+// -----------------------------------------------------------
+// All children finish before the group goes out of scope.
+// Cancellation is cooperative: children that have not started yet are skipped,
+// running children can poll IsCancelled() and return early.
+class TaskGroup {
+public:
+    explicit TaskGroup(ThreadPool &pool) : m_Pool(pool) {}
+
+    // Forgot Wait()? Cancel what hasn't started and wait for the rest.
+    // Errors are dropped here - a destructor must not throw.
+    ~TaskGroup() {
+        if (m_Pending.load(std::memory_order_acquire) != 0) {
+            Cancel();
+            m_Pool.RunUntil([this] { return m_Pending.load(std::memory_order_acquire) == 0; }, true);
+        }
+    }
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup & operator=(const TaskGroup&) = delete;
+
+    // Children may Spawn() more children into the same group
+    template <typename F>
+    void Spawn(F &&f) {
+        m_Pending.fetch_add(1, std::memory_order_relaxed);
+        m_Pool.Submit([this, fn = std::forward<F>(f)]() mutable {
+            if (!IsCancelled()) {
+                try {
+                    fn();
+                } catch (...) {
+                    AddError(std::current_exception());
+                }
+            }
+            Finish();
+        });
+    }
+
+    // Joins all children, running queued tasks instead of sleeping.
+    // Throws TaskGroupError if any child threw.
+    void Wait() {
+        m_Pool.RunUntil([this] { return m_Pending.load(std::memory_order_acquire) == 0; }, true);
+        std::vector<std::exception_ptr> errors;
+        {
+            std::lock_guard<std::mutex> lock(m_ErrorMutex);
+            errors.swap(m_Errors);
+        }
+        if (!errors.empty()) throw TaskGroupError(std::move(errors));
+    }
+
+    void Cancel() { m_Cancelled.store(true, std::memory_order_relaxed); }
+    bool IsCancelled() const { return m_Cancelled.load(std::memory_order_relaxed); }
+
+private:
+    void AddError(std::exception_ptr error) {
+        {
+            std::lock_guard<std::mutex> lock(m_ErrorMutex);
+            m_Errors.push_back(std::move(error));
+        }
+        Cancel();                                   // first failure stops the siblings
+    }
+
+    // Once m_Pending hits 0 a waiter may return from Wait() and destroy the
+    // group (it lives on the waiter's stack) → no access to *this after the
+    // decrement; the pool outlives every group.
+    void Finish() {
+        ThreadPool &pool = m_Pool;
+        if (m_Pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            pool.NotifyAll();                       // last child: wake the waiter
+        }
+    }
+
+    ThreadPool &m_Pool;
+    std::atomic<long long> m_Pending{0};
+    std::atomic<bool> m_Cancelled{false};
+    std::mutex m_ErrorMutex;
+    std::vector<std::exception_ptr> m_Errors;
+};
+
+// -----------------------------------------------------------
+// Sample functions from 3_Thread_return_value_from_thread.cpp (shorter sleep)
+int Add(int a, int b) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100)); // simulate work
+    return a + b;
+}
+
+int mul(int a, int b) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100)); // simulate work
+    return a * b;
+}
+
+// Tiny child task for the benchmark
+std::atomic<long long> g_Sum{0};
+void Leaf(int i) { g_Sum.fetch_add(i, std::memory_order_relaxed); }
+
+// Recursive fork-join: every level waits for its own children. With
+// blocking future.get() this deadlocks once the tree is deeper than the
+// number of workers; with TaskGroup the waiting thread keeps executing.
+void SumRange(ThreadPool &pool, int begin, int end) {
+    if (end - begin <= 1) {
+        if (begin < end) Leaf(begin);
+        return;
+    }
+    const int mid = begin + (end - begin) / 2;
+    TaskGroup group(pool);
+    group.Spawn([&pool, begin, mid] { SumRange(pool, begin, mid); });
+    SumRange(pool, mid, end);
+    group.Wait();
+}
+
+double Seconds(std::chrono::steady_clock::time_point begin) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+}
+
+int main() {
+    const unsigned workers = std::max(2u, std::thread::hardware_concurrency());
+    ThreadPool pool(workers);
+
+    // Step 1: Case 3 of 3_Thread_return_value_from_thread.cpp as a group
+    {
+        int sum = 0, product = 0;
+        TaskGroup group(pool);
+        group.Spawn([&] { sum = Add(10, 20); });
+        group.Spawn([&] { product = mul(10, 20); });
+        group.Wait();                       // both done, results visible
+        std::cout << "Addition is : " << sum << ", Multiplication is : " << product << std::endl;
+    }
+
+    // Step 2: failures cancel the siblings and are reported together
+    {
+        std::atomic<int> ran{0}, stoppedEarly{0};
+        TaskGroup group(pool);
+        for (int i = 0; i < 20; ++i) {
+            group.Spawn([&, i] {
+                ++ran;
+                if (i < 2) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                    throw std::runtime_error("download " + std::to_string(i) + " failed");
+                }
+                for (int step = 0; step < 50; ++step) {             // long task, polls for cancellation
+                    if (group.IsCancelled()) { ++stoppedEarly; return; }
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+            });
+        }
+        try {
+            group.Wait();
+        } catch (const TaskGroupError &ex) {
+            std::cout << "[main] caught: " << ex.what() << " (" << ex.Errors().size() << " errors), "
+                      << ran << "/20 started, " << stoppedEarly << " stopped early" << std::endl;
+        }
+    }
+
+    // Step 3: no Wait() → the destructor cancels and joins, no std::terminate
+    {
+        std::atomic<int> ran{0};
+        {
+            TaskGroup group(pool);
+            for (int i = 0; i < 1000; ++i) group.Spawn([&] { ++ran; });
+        }
+        std::cout << "[main] group left without Wait(): " << ran << " of 1000 ran, nothing leaked" << std::endl;
+    }
+
+    // Step 4: benchmark - 1M children
+    const int CHILDREN = 1000000;
+    const long long expected = static_cast<long long>(CHILDREN) * (CHILDREN - 1) / 2;
+    std::cout << "\n" << CHILDREN << " child tasks, " << workers << " workers\n"
+              << std::left << std::setw(34) << "method" << std::right
+              << std::setw(12) << "time ms" << std::setw(14) << "ns/task" << std::endl;
+    auto Report = [&](const char *name, double secs) {
+        std::cout << std::left << std::setw(34) << name << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(12) << secs * 1e3 << std::setw(14) << secs * 1e9 / CHILDREN
+                  << (g_Sum.load() == expected ? "" : "   WRONG SUM") << std::endl;
+    };
+
+    {
+        g_Sum = 0;
+        auto begin = std::chrono::steady_clock::now();
+        std::vector<std::future<void>> futures;
+        futures.reserve(CHILDREN);
+        for (int i = 0; i < CHILDREN; ++i) futures.push_back(pool.Async([i] { Leaf(i); }));
+        for (auto &f : futures) f.get();                // main thread blocks, does no work
+        Report("vector<future>.get()", Seconds(begin));
+    }
+    {
+        g_Sum = 0;
+        auto begin = std::chrono::steady_clock::now();
+        TaskGroup group(pool);
+        for (int i = 0; i < CHILDREN; ++i) group.Spawn([i] { Leaf(i); });
+        group.Wait();                                   // main thread helps
+        Report("TaskGroup flat, Wait() helps", Seconds(begin));
+    }
+    {
+        g_Sum = 0;
+        auto begin = std::chrono::steady_clock::now();
+        SumRange(pool, 0, CHILDREN);
+        Report("TaskGroup nested fork-join", Seconds(begin));
+    }
+
+    return 0;
+}
+
+/* ------------------------------------------------------------------
+THEORY & KEY POINTS: Structured concurrency (task groups / nurseries)
+
+1. The problem with loose threads and futures:
+   - Forgot join() → std::terminate.
+   - One task throws → the others keep running; you only see the error
+     when (if) you call get() on that particular future.
+   - The lifetime of a task is not tied to any scope.
+
+2. Task group rule: "children never outlive their parent scope"
+   - Spawn() starts a child, Wait() joins ALL children.
+   - The destructor waits too (after cancelling) → no dangling references
+     to locals captured by reference, no terminate.
+
+3. Errors:
+   - The first exception sets the cancel flag.
+   - Children not started yet are skipped; running ones poll IsCancelled().
+   - Wait() throws ONE TaskGroupError holding ALL exception_ptrs.
+
+4. Wait by helping:
+   - future.get() puts the thread to sleep → with a fixed pool, nested
+     waits can use up every worker → deadlock.
+   - Wait() instead pops tasks from the pool queue and runs them until its
+     own counter reaches zero. The waiting thread is one more worker.
+   - It pops the NEWEST task (LIFO), like the owner of a work-stealing deque:
+     taking the oldest one would start a huge unrelated subtree on top of the
+     current stack → stack overflow in deep recursive fork-join.
+
+5. Cost per task here:
+   - std::function + one queue push/pop under a mutex.
+   - vector<future> adds a packaged_task, a shared state, a future per
+     task, and a blocking get() per task.
+   - Work-stealing deques (per-thread queues) would remove the single
+     mutex.
+
+------------------------------------------------------------------
+
+💡 Memory Tip / Analogy
+	•	A nursery: kids go in, and the teacher only leaves when every kid has been picked up.
+	•	One kid gets sick → the teacher cancels the trip for everybody still in line.
+	•	A waiting teacher doesn't just stand there - they help the other kids tie their shoes.
+
+*/
@@ -0,0 +1,380 @@
+// 22_Thread_scheduling_classes.cpp
+// clang++ -std=c++17 -O2 -pthread 22_Thread_scheduling_classes.cpp -o a; ./a
+// @author :  DhiraxD
+// @brief  : std::async (6_, 7_) treats every task the same: a 20-second mul()
+//           delays a latency-sensitive task as much as anything else.
+//           This executor has scheduling classes:
+//           - Interactive / Normal / Batch, one queue per class, served by priority
+//           - optional EDF (earliest deadline first) inside each class
+//           - starvation protection: a class that waited too long is served next
+//           Benchmark: p99 latency of interactive tasks while batch work saturates
+//           every worker, compared with one FIFO queue.
+// References:
+// https://en.cppreference.com/w/cpp/thread/async
+// https://en.wikipedia.org/wiki/Earliest_deadline_first_scheduling
+// https://en.wikipedia.org/wiki/Starvation_(computer_science)
+// https://en.wikipedia.org/wiki/Aging_(scheduling)
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <deque>
+#include <array>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <functional>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <string>
+#include <cstdint>
+
+using Clock = std::chrono::steady_clock;
+
+// -----------------------------------------------------------
+enum class SchedClass { Interactive = 0, Normal = 1, Batch = 2 };
+const int CLASS_COUNT = 3;
+
+struct SchedulerOptions {
+    // EDF: order each class by deadline. A task without an explicit deadline
+    // gets "submit time + budget of its class".
+    bool edf = false;
+    std::array<Clock::duration, CLASS_COUNT> budget = {
+        std::chrono::milliseconds(10), std::chrono::milliseconds(100), std::chrono::seconds(10)};
+    // Starvation protection: a non-empty class not served for this long is served
+    // next, whatever is waiting above it. Clock::duration::max() = never.
+    std::array<Clock::duration, CLASS_COUNT> maxWait = {
+        Clock::duration::max(), std::chrono::milliseconds(50), std::chrono::milliseconds(200)};
+};
+
+class ClassExecutor {
+public:
+    explicit ClassExecutor(unsigned workers, SchedulerOptions options = {}) : m_Opt(options) {
+        for (auto &q : m_Queues) q.lastServed = Clock::now();
+        for (unsigned i = 0; i < workers; ++i) {
+            m_Workers.emplace_back([this] { WorkerLoop(); });
+        }
+    }
+
+    ~ClassExecutor() {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Stop = true;
+        }
+        m_CV.notify_all();
+        for (auto &t : m_Workers) t.join();
+    }
+
+    void Submit(SchedClass c, std::function<void()> fn) {
+        const auto now = Clock::now();
+        Push(c, std::move(fn), now + m_Opt.budget[int(c)], now);
+    }
+
+    void Submit(SchedClass c, Clock::time_point deadline, std::function<void()> fn) {
+        Push(c, std::move(fn), deadline, Clock::now());
+    }
+
+    // Like std::async, but with a class
+    template <typename F, typename R = std::invoke_result_t<std::decay_t<F>&>>
+    std::future<R> Async(SchedClass c, F &&f) {
+        auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(f));
+        std::future<R> result = task->get_future();
+        Submit(c, [task] { (*task)(); });
+        return result;
+    }
+
+    // Blocks until every queue is empty and no task is running
+    void WaitIdle() {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_IdleCV.wait(lock, [this] { return m_Queued == 0 && m_Running == 0; });
+    }
+
+    // How often starvation protection picked a class out of priority order
+    long long Rescues(SchedClass c) const {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_Queues[int(c)].rescues;
+    }
+
+private:
+    struct Entry {
+        std::function<void()> fn;
+        Clock::time_point deadline;
+        std::uint64_t seq;
+        bool operator>(const Entry &other) const {      // min-heap: earliest deadline, then oldest
+            return deadline != other.deadline ? deadline > other.deadline : seq > other.seq;
+        }
+    };
+
+    struct ClassQueue {
+        std::deque<Entry> fifo;
+        std::vector<Entry> edf;             // min-heap via push_heap/pop_heap
+        Clock::time_point lastServed;
+        long long rescues = 0;
+        bool empty() const { return fifo.empty() && edf.empty(); }
+    };
+
+    void Push(SchedClass c, std::function<void()> fn, Clock::time_point deadline, Clock::time_point now) {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            ClassQueue &q = m_Queues[int(c)];
+            if (q.empty()) q.lastServed = now;     // waiting time starts now, not at the last service
+            Entry e{std::move(fn), deadline, m_Seq++};
+            if (m_Opt.edf) {
+                q.edf.push_back(std::move(e));
+                std::push_heap(q.edf.begin(), q.edf.end(), std::greater<Entry>());
+            } else {
+                q.fifo.push_back(std::move(e));
+            }
+            ++m_Queued;
+        }
+        m_CV.notify_one();
+    }
+
+    // Called with m_Mutex held and at least one task queued
+    Entry PickNext() {
+        const auto now = Clock::now();
+        int chosen = -1;
+        // 1) starvation protection: lowest class first, it is the one at risk
+        for (int c = CLASS_COUNT - 1; c >= 0 && chosen < 0; --c) {
+            const ClassQueue &q = m_Queues[c];
+            if (!q.empty() && m_Opt.maxWait[c] != Clock::duration::max() && now - q.lastServed > m_Opt.maxWait[c]) {
+                chosen = c;
+                ++m_Queues[c].rescues;
+            }
+        }
+        // 2) otherwise strict priority
+        for (int c = 0; c < CLASS_COUNT && chosen < 0; ++c) {
+            if (!m_Queues[c].empty()) chosen = c;
+        }
+        ClassQueue &q = m_Queues[chosen];
+        q.lastServed = now;
+        Entry e;
+        if (m_Opt.edf) {
+            std::pop_heap(q.edf.begin(), q.edf.end(), std::greater<Entry>());
+            e = std::move(q.edf.back());
+            q.edf.pop_back();
+        } else {
+            e = std::move(q.fifo.front());
+            q.fifo.pop_front();
+        }
+        --m_Queued;
+        return e;
+    }
+
+    void WorkerLoop() {
+        while (true) {
+            Entry e;
+            {
+                std::unique_lock<std::mutex> lock(m_Mutex);
+                m_CV.wait(lock, [this] { return m_Stop || m_Queued > 0; });
+                if (m_Queued == 0) return;          // stop requested and drained
+                e = PickNext();
+                ++m_Running;
+            }
+            e.fn();
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                --m_Running;
+                if (m_Queued == 0 && m_Running == 0) m_IdleCV.notify_all();
+            }
+        }
+    }
+
+    SchedulerOptions m_Opt;
+    mutable std::mutex m_Mutex;
+    std::condition_variable m_CV, m_IdleCV;
+    std::array<ClassQueue, CLASS_COUNT> m_Queues;
+    std::size_t m_Queued = 0, m_Running = 0;
+    std::uint64_t m_Seq = 0;
+    bool m_Stop = false;
+    std::vector<std::thread> m_Workers;
+};
+
+// -----------------------------------------------------------
+// Baseline: one FIFO queue for everything (what a plain pool / std::async gives you).
+// Same class as above with a single class and no protection.
+class FifoExecutor {
+public:
+    explicit FifoExecutor(unsigned workers) : m_Impl(workers, FifoOptions()) {}
+    void Submit(SchedClass, std::function<void()> fn) { m_Impl.Submit(SchedClass::Normal, std::move(fn)); }
+    void WaitIdle() { m_Impl.WaitIdle(); }
+
+private:
+    static SchedulerOptions FifoOptions() {
+        SchedulerOptions o;
+        o.maxWait.fill(Clock::duration::max());
+        return o;
+    }
+    ClassExecutor m_Impl;
+};
+
+// -----------------------------------------------------------
+// Busy work, so tasks really occupy their worker
+void Spin(Clock::duration d) {
+    const auto until = Clock::now() + d;
+    while (Clock::now() < until) {}
+}
+
+double Percentile(std::vector<double> v, double p) {
+    if (v.empty()) return 0;
+    std::sort(v.begin(), v.end());
+    return v[std::min(v.size() - 1, static_cast<std::size_t>(p * v.size()))];
+}
+
+const auto BATCH_TASK = std::chrono::milliseconds(2);
+const auto INTERACTIVE_TASK = std::chrono::microseconds(20);
+const auto INTERACTIVE_PERIOD = std::chrono::milliseconds(2);
+const int INTERACTIVE_COUNT = 300;
+
+// Saturate the workers with batch work, then send interactive requests at a
+// steady rate and measure submit → finish latency of each one.
+template <typename Executor>
+void Saturation(const char *name, Executor &executor, unsigned workers) {
+    const int batchTasks = static_cast<int>(workers * (INTERACTIVE_COUNT * INTERACTIVE_PERIOD) / BATCH_TASK);
+    std::atomic<int> batchDone{0};
+    for (int i = 0; i < batchTasks; ++i) {
+        executor.Submit(SchedClass::Batch, [&] { Spin(BATCH_TASK); ++batchDone; });
+    }
+
+    std::vector<double> latencyMs(INTERACTIVE_COUNT);
+    auto next = Clock::now();
+    for (int i = 0; i < INTERACTIVE_COUNT; ++i) {
+        std::this_thread::sleep_until(next);
+        next += INTERACTIVE_PERIOD;
+        const auto submitted = Clock::now();
+        executor.Submit(SchedClass::Interactive, [&latencyMs, i, submitted] {
+            Spin(INTERACTIVE_TASK);
+            latencyMs[i] = std::chrono::duration<double, std::milli>(Clock::now() - submitted).count();
+        });
+    }
+    const int batchWhileInteractive = batchDone.load();
+    executor.WaitIdle();
+
+    std::cout << std::left << std::setw(24) << name << std::right << std::fixed << std::setprecision(2)
+              << std::setw(10) << Percentile(latencyMs, 0.50)
+              << std::setw(10) << Percentile(latencyMs, 0.99)
+              << std::setw(10) << Percentile(latencyMs, 1.0)
+              << std::setw(18) << batchWhileInteractive << "/" << batchTasks << std::endl;
+}
+
+int main() {
+    using namespace std::chrono_literals;
+    const unsigned workers = std::max(2u, std::thread::hardware_concurrency());
+
+    // Step 1: the 20-second mul() of 6_Thread_task_based_concurrency.cpp as
+    // batch work (shortened), Add() as interactive: Add does not queue behind mul
+    {
+        ClassExecutor executor(1);
+        auto begin = Clock::now();
+        auto Ms = [&] { return std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - begin).count(); };
+        executor.Submit(SchedClass::Batch, [&] { std::this_thread::sleep_for(50ms); });   // occupies the worker
+        auto mul = executor.Async(SchedClass::Batch, [&] { std::this_thread::sleep_for(200ms); return 10 * 20; });
+        auto add = executor.Async(SchedClass::Interactive, [&] { return 10 + 20; });
+        std::cout << "[main] Add (interactive) = " << add.get() << " after " << Ms() << " ms" << std::endl;
+        std::cout << "[main] mul (batch)       = " << mul.get() << " after " << Ms() << " ms" << std::endl;
+    }
+
+    // Step 2: EDF - deadlines decide the order, not the submit order
+    {
+        SchedulerOptions options;
+        options.edf = true;
+        ClassExecutor executor(1, options);
+        std::mutex printMutex;
+        executor.Submit(SchedClass::Normal, [] { std::this_thread::sleep_for(20ms); });   // let the queue fill
+        const auto now = Clock::now();
+        for (int ms : {300, 100, 200, 50}) {
+            executor.Submit(SchedClass::Normal, now + std::chrono::milliseconds(ms), [&, ms] {
+                std::lock_guard<std::mutex> lock(printMutex);
+                std::cout << "[EDF] ran task with deadline +" << ms << "ms" << std::endl;
+            });
+        }
+        executor.WaitIdle();
+    }
+
+    // Step 3: starvation protection - interactive flood, a few batch tasks
+    for (bool protect : {false, true}) {
+        SchedulerOptions options;
+        if (!protect) options.maxWait.fill(Clock::duration::max());
+        ClassExecutor executor(workers, options);
+        const auto begin = Clock::now();
+        std::atomic<long long> firstBatchMs{-1};
+        for (int i = 0; i < 400 * int(workers); ++i) {
+            executor.Submit(SchedClass::Interactive, [] { Spin(1ms); });
+        }
+        for (int i = 0; i < 3; ++i) {
+            executor.Submit(SchedClass::Batch, [&] {
+                long long expected = -1;
+                firstBatchMs.compare_exchange_strong(expected,
+                    std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - begin).count());
+            });
+        }
+        executor.WaitIdle();
+        std::cout << "[starvation] protection " << (protect ? "on " : "off") << ": first batch task started after "
+                  << firstBatchMs << " ms of a " << 400 * workers << " x 1ms interactive flood, rescues = "
+                  << executor.Rescues(SchedClass::Batch) << std::endl;
+    }
+
+    // Step 4: p99 latency of interactive tasks under batch saturation
+    std::cout << "\n" << workers << " workers saturated with " << BATCH_TASK.count() << "ms batch tasks, "
+              << INTERACTIVE_COUNT << " interactive requests every " << INTERACTIVE_PERIOD.count() << "ms\n"
+              << std::left << std::setw(24) << "executor" << std::right
+              << std::setw(10) << "p50 ms" << std::setw(10) << "p99 ms" << std::setw(10) << "max ms"
+              << std::setw(24) << "batch done meanwhile" << std::endl;
+    {
+        FifoExecutor executor(workers);
+        Saturation("one FIFO queue", executor, workers);
+    }
+    {
+        ClassExecutor executor(workers);
+        Saturation("classes, FIFO inside", executor, workers);
+    }
+    {
+        SchedulerOptions options;
+        options.edf = true;
+        ClassExecutor executor(workers, options);
+        Saturation("classes + EDF", executor, workers);
+    }
+
+    return 0;
+}
+
+/* ------------------------------------------------------------------
+THEORY & KEY POINTS: Scheduling classes
+
+1. One FIFO queue = no notion of urgency:
+   - A click handler submitted behind 1000 batch jobs waits for all of them.
+   - Latency of urgent work = length of the backlog.
+
+2. Scheduling classes:
+   - One queue per class: Interactive > Normal > Batch.
+   - A free worker takes from the highest non-empty class.
+   - Interactive latency ≈ time until ANY worker finishes its current task
+     (tasks are not preempted - keep batch tasks short or split them).
+
+3. EDF (earliest deadline first):
+   - Inside a class, run the task whose deadline is closest.
+   - Optimal on one CPU when the work is feasible at all.
+   - Tasks without a deadline get "now + class budget" → older tasks'
+     deadlines come closer automatically (a built-in form of aging).
+
+4. Starvation:
+   - Strict priority: if interactive work never stops, batch never runs.
+   - Protection here: if a non-empty class hasn't been served for maxWait,
+     it is served next (lowest class checked first).
+   - Result: batch gets at least one task per maxWait even under a flood.
+
+5. Measure percentiles, not averages:
+   - p99 = 99% of requests were at least this fast.
+   - Averages hide the few requests that waited behind a long batch task.
+
+------------------------------------------------------------------
+
+💡 Memory Tip / Analogy
+	•	Hospital triage: emergencies first (interactive), then regular patients, then check-ups (batch).
+	•	EDF = the patient whose appointment is soonest goes first.
+	•	Starvation protection = nobody waits in the check-up line forever; every so often one is called in anyway.
+
+*/
@@ -0,0 +1,735 @@
+// 23_Thread_fibers.cpp
+// clang++ -std=c++17 -O2 -pthread 23_Thread_fibers.cpp -o a; ./a
+// @author :  DhiraxD
+// @brief  : User-space fibers: keep the blocking style of the examples
+//           (sleep_for in Add/mul, cv.wait in ProcessData, f.get() in Operation)
+//           but run 100k of them on ONE OS thread.
+//           - small mmap'd stacks with a PROT_NONE guard page
+//           - hand-written context switch for x86-64 and AArch64 (ucontext elsewhere)
+//           - FiberMutex / FiberConditionVariable / FiberPromise+FiberFuture /
+//             this_fiber::SleepFor: they suspend the fiber, never the OS thread
+//           Benchmark: switch cost and memory per fiber vs std::thread. (Linux)
+// References:
+// https://en.wikipedia.org/wiki/Fiber_(computer_science)
+// https://gitlab.com/x86-psABIs/x86-64-ABI (callee-saved registers)
+// https://github.com/ARM-software/abi-aa/blob/main/aapcs64/aapcs64.rst
+// https://www.boost.org/doc/libs/release/libs/context/doc/html/index.html
+// https://man7.org/linux/man-pages/man2/mprotect.2.html
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <vector>
+#include <deque>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <optional>
+#include <string>
+#include <exception>
+#include <stdexcept>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#if !defined(__x86_64__) && !defined(__aarch64__)
+#include <ucontext.h>
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+// -----------------------------------------------------------
+// Context switch: save the callee-saved registers on the current stack,
+// store the stack pointer in *saveSp, load newSp, restore, return.
+// Everything else (caller-saved registers) the compiler already spilled,
+// because to it this is just an ordinary function call.
+#if defined(__x86_64__)
+asm(R"(
+    .text
+    .globl FiberSwitch
+    .type FiberSwitch,@function
+    .align 16
+FiberSwitch:
+    pushq %rbp
+    pushq %rbx
+    pushq %r12
+    pushq %r13
+    pushq %r14
+    pushq %r15
+    subq $8, %rsp
+    stmxcsr (%rsp)
+    fnstcw 4(%rsp)
+    movq %rsp, (%rdi)
+    movq %rsi, %rsp
+    ldmxcsr (%rsp)
+    fldcw 4(%rsp)
+    addq $8, %rsp
+    popq %r15
+    popq %r14
+    popq %r13
+    popq %r12
+    popq %rbx
+    popq %rbp
+    ret
+    .size FiberSwitch,.-FiberSwitch
+)");
+#elif defined(__aarch64__)
+asm(R"(
+    .text
+    .globl FiberSwitch
+    .type FiberSwitch,%function
+    .align 4
+FiberSwitch:
+    sub sp, sp, #160
+    stp x19, x20, [sp, #0]
+    stp x21, x22, [sp, #16]
+    stp x23, x24, [sp, #32]
+    stp x25, x26, [sp, #48]
+    stp x27, x28, [sp, #64]
+    stp x29, x30, [sp, #80]
+    stp d8,  d9,  [sp, #96]
+    stp d10, d11, [sp, #112]
+    stp d12, d13, [sp, #128]
+    stp d14, d15, [sp, #144]
+    mov x9, sp
+    str x9, [x0]
+    mov sp, x1
+    ldp x19, x20, [sp, #0]
+    ldp x21, x22, [sp, #16]
+    ldp x23, x24, [sp, #32]
+    ldp x25, x26, [sp, #48]
+    ldp x27, x28, [sp, #64]
+    ldp x29, x30, [sp, #80]
+    ldp d8,  d9,  [sp, #96]
+    ldp d10, d11, [sp, #112]
+    ldp d12, d13, [sp, #128]
+    ldp d14, d15, [sp, #144]
+    add sp, sp, #160
+    ret
+    .size FiberSwitch,.-FiberSwitch
+)");
+#endif
+
+#if defined(__x86_64__) || defined(__aarch64__)
+extern "C" void FiberSwitch(void **saveSp, void *newSp);
+
+struct Context {
+    void *sp = nullptr;
+};
+
+// Lays out a fresh stack so that the first FiberSwitch() into it "returns"
+// into entry() with a correctly aligned stack
+void MakeContext(Context &ctx, char *stackTop, void (*entry)()) {
+    auto *sp = reinterpret_cast<std::uintptr_t*>(reinterpret_cast<std::uintptr_t>(stackTop) & ~std::uintptr_t(15));
+#if defined(__x86_64__)
+    *--sp = 0;                                          // fake return address of entry()
+    *--sp = reinterpret_cast<std::uintptr_t>(entry);    // popped by `ret`
+    for (int i = 0; i < 6; ++i) *--sp = 0;              // rbp rbx r12 r13 r14 r15
+    *--sp = (std::uintptr_t(0x037F) << 32) | 0x1F80;    // default x87 control word | MXCSR
+#else
+    sp -= 20;                                           // 160-byte frame, see FiberSwitch
+    std::memset(sp, 0, 160);
+    sp[11] = reinterpret_cast<std::uintptr_t>(entry);   // x30 (link register) at offset 88
+#endif
+    ctx.sp = sp;
+}
+
+inline void SwitchContext(Context &from, Context &to) { FiberSwitch(&from.sp, to.sp); }
+#else
+// Portable fallback (slower: swapcontext also saves the signal mask → syscall)
+struct Context {
+    ucontext_t uc;
+};
+
+void MakeContext(Context &ctx, char *stackTop, std::size_t stackSize, void (*entry)()) {
+    getcontext(&ctx.uc);
+    ctx.uc.uc_stack.ss_sp = stackTop - stackSize;
+    ctx.uc.uc_stack.ss_size = stackSize;
+    ctx.uc.uc_link = nullptr;
+    makecontext(&ctx.uc, entry, 0);
+}
+
+inline void SwitchContext(Context &from, Context &to) { swapcontext(&from.uc, &to.uc); }
+#endif
+
+// -----------------------------------------------------------
+// Stacks: mmap'd, memory is committed only when a page is touched.
+// With a guard page: an overflow hits PROT_NONE → SIGSEGV instead of silently
+// overwriting the neighbour's stack. Each guarded stack is 2 kernel mappings
+// (vm.max_map_count, usually 65530) → unguarded stacks come from big slabs.
+class StackAllocator {
+public:
+    StackAllocator(std::size_t stackSize, bool guardPage)
+        : m_Page(static_cast<std::size_t>(::sysconf(_SC_PAGESIZE))),
+          m_Size((stackSize + m_Page - 1) / m_Page * m_Page), m_Guard(guardPage) {}
+
+    ~StackAllocator() {
+        if (m_Guard) {
+            for (char *base : m_Free) ::munmap(base - m_Page, m_Size + m_Page);
+        }
+        for (auto &slab : m_Slabs) ::munmap(slab.first, slab.second);
+    }
+    StackAllocator(const StackAllocator&) = delete;
+    StackAllocator & operator=(const StackAllocator&) = delete;
+
+    std::size_t Size() const { return m_Size; }
+
+    // Returns the LOWEST usable address; the stack grows down from base + Size()
+    char * Allocate() {
+        if (!m_Free.empty()) {
+            char *base = m_Free.back();
+            m_Free.pop_back();
+            return base;
+        }
+        if (m_Guard) {
+            void *p = ::mmap(nullptr, m_Size + m_Page, PROT_READ | PROT_WRITE,
+                             MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+            if (p == MAP_FAILED) throw std::bad_alloc();
+            ::mprotect(p, m_Page, PROT_NONE);           // guard below the stack
+            return static_cast<char*>(p) + m_Page;
+        }
+        const std::size_t SLAB = 256;
+        void *p = ::mmap(nullptr, m_Size * SLAB, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (p == MAP_FAILED) throw std::bad_alloc();
+        m_Slabs.emplace_back(p, m_Size * SLAB);
+        for (std::size_t i = 1; i < SLAB; ++i) m_Free.push_back(static_cast<char*>(p) + i * m_Size);
+        return static_cast<char*>(p);
+    }
+
+    void Release(char *base) { m_Free.push_back(base); }    // reused by the next fiber
+
+private:
+    std::size_t m_Page, m_Size;
+    bool m_Guard;
+    std::vector<char*> m_Free;
+    std::vector<std::pair<void*, std::size_t>> m_Slabs;
+};
+
+// -----------------------------------------------------------
+struct Fiber {
+    Context ctx;
+    std::function<void()> fn;
+    char *stack = nullptr;
+    bool done = false;
+};
+
+// One scheduler per OS thread; all its fibers run on that thread, so the
+// fiber primitives below need no atomics (and must not be shared across
+// schedulers).
+class Scheduler {
+public:
+    struct Options {
+        std::size_t stackSize = 64 * 1024;
+        bool guardPage = true;
+    };
+
+    Scheduler() : Scheduler(Options()) {}
+    explicit Scheduler(Options options) : m_Stacks(options.stackSize, options.guardPage) {}
+    Scheduler(const Scheduler&) = delete;
+    Scheduler & operator=(const Scheduler&) = delete;
+
+    static Scheduler & Current() { return *t_Current; }
+
+    void Spawn(std::function<void()> fn) {
+        auto *f = new Fiber;
+        f->fn = std::move(fn);
+        f->stack = m_Stacks.Allocate();
+#if defined(__x86_64__) || defined(__aarch64__)
+        MakeContext(f->ctx, f->stack + m_Stacks.Size(), &FiberMain);
+#else
+        MakeContext(f->ctx, f->stack + m_Stacks.Size(), m_Stacks.Size(), &FiberMain);
+#endif
+        m_Ready.push_back(f);
+        ++m_Alive;
+    }
+
+    // Runs until every fiber has finished
+    void Run() {
+        Scheduler *previous = t_Current;
+        t_Current = this;
+        while (m_Alive > 0) {
+            FireTimers();
+            if (m_Ready.empty()) {
+                if (m_Timers.empty()) throw std::logic_error("deadlock: every fiber is blocked");
+                std::this_thread::sleep_until(m_Timers.top().when);     // nothing to do: OS thread sleeps
+                continue;
+            }
+            Fiber *f = m_Ready.front();
+            m_Ready.pop_front();
+            m_Running = f;
+            SwitchContext(m_MainContext, f->ctx);
+            m_Running = nullptr;
+            if (f->done) {
+                m_Stacks.Release(f->stack);
+                delete f;
+                --m_Alive;
+            }
+        }
+        t_Current = previous;
+    }
+
+    Fiber * Running() const { return m_Running; }
+
+    // Back of the ready queue, let the others run
+    void Yield() {
+        m_Ready.push_back(m_Running);
+        SwitchContext(m_Running->ctx, m_MainContext);
+    }
+
+    // Park the running fiber; someone must Wake() it (it is in their wait list)
+    void Suspend() { SwitchContext(m_Running->ctx, m_MainContext); }
+    void Wake(Fiber *f) { m_Ready.push_back(f); }
+
+    void SleepUntil(Clock::time_point when) {
+        m_Timers.push({when, m_Seq++, m_Running});
+        Suspend();
+    }
+
+private:
+    struct Timer {
+        Clock::time_point when;
+        std::uint64_t seq;
+        Fiber *fiber;
+        bool operator>(const Timer &other) const {
+            return when != other.when ? when > other.when : seq > other.seq;
+        }
+    };
+
+    static void FiberMain() {
+        Scheduler &s = Current();
+        Fiber *self = s.m_Running;
+        try {
+            self->fn();
+        } catch (...) {
+            std::terminate();               // same rule as an exception escaping std::thread
+        }
+        self->fn = nullptr;                 // destroy captures while still on this stack
+        self->done = true;
+        SwitchContext(self->ctx, s.m_MainContext);
+        std::abort();                       // never resumed
+    }
+
+    void FireTimers() {
+        if (m_Timers.empty()) return;
+        const auto now = Clock::now();
+        while (!m_Timers.empty() && m_Timers.top().when <= now) {
+            m_Ready.push_back(m_Timers.top().fiber);
+            m_Timers.pop();
+        }
+    }
+
+    static thread_local Scheduler *t_Current;
+
+    StackAllocator m_Stacks;
+    Context m_MainContext;
+    Fiber *m_Running = nullptr;
+    std::deque<Fiber*> m_Ready;
+    std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> m_Timers;
+    std::uint64_t m_Seq = 0;
+    std::size_t m_Alive = 0;
+};
+
+thread_local Scheduler *Scheduler::t_Current = nullptr;
+
+namespace this_fiber {
+inline void Yield() { Scheduler::Current().Yield(); }
+
+template <typename Rep, typename Period>
+void SleepFor(std::chrono::duration<Rep, Period> d) {
+    Scheduler::Current().SleepUntil(Clock::now() + std::chrono::duration_cast<Clock::duration>(d));
+}
+} // namespace this_fiber
+
+// -----------------------------------------------------------
+// Fiber-aware synchronization: same interfaces as the std:: ones, but a
+// waiting fiber is parked and the OS thread keeps running other fibers.
+class FiberMutex {
+public:
+    void lock() {
+        if (!m_Locked) {
+            m_Locked = true;
+            return;
+        }
+        m_Waiters.push_back(Scheduler::Current().Running());
+        Scheduler::Current().Suspend();     // unlock() handed the lock to us
+    }
+    bool try_lock() {
+        if (m_Locked) return false;
+        m_Locked = true;
+        return true;
+    }
+    void unlock() {
+        if (m_Waiters.empty()) {
+            m_Locked = false;
+            return;
+        }
+        Fiber *next = m_Waiters.front();    // hand-off: stays locked, next owner wakes up
+        m_Waiters.pop_front();
+        Scheduler::Current().Wake(next);
+    }
+
+private:
+    bool m_Locked = false;
+    std::deque<Fiber*> m_Waiters;
+};
+
+class FiberConditionVariable {
+public:
+    void wait(std::unique_lock<FiberMutex> &lock) {
+        m_Waiters.push_back(Scheduler::Current().Running());
+        lock.unlock();
+        Scheduler::Current().Suspend();
+        lock.lock();
+    }
+    template <typename Predicate>
+    void wait(std::unique_lock<FiberMutex> &lock, Predicate pred) {
+        while (!pred()) wait(lock);
+    }
+    void notify_one() {
+        if (m_Waiters.empty()) return;
+        Scheduler::Current().Wake(m_Waiters.front());
+        m_Waiters.pop_front();
+    }
+    void notify_all() {
+        while (!m_Waiters.empty()) notify_one();
+    }
+
+private:
+    std::deque<Fiber*> m_Waiters;
+};
+
+template <typename T>
+class FiberFuture;
+
+template <typename T>
+class FiberPromise {
+    struct State {
+        std::optional<T> value;
+        std::exception_ptr error;
+        FiberConditionVariable ready;
+        FiberMutex mutex;
+    };
+
+public:
+    FiberPromise() : m_State(std::make_shared<State>()) {}
+    FiberFuture<T> get_future() { return FiberFuture<T>(m_State); }
+
+    void set_value(T value) {
+        m_State->value = std::move(value);
+        m_State->ready.notify_all();
+    }
+    void set_exception(std::exception_ptr e) {
+        m_State->error = e;
+        m_State->ready.notify_all();
+    }
+
+private:
+    friend class FiberFuture<T>;
+    std::shared_ptr<State> m_State;
+};
+
+template <typename T>
+class FiberFuture {
+public:
+    T get() {
+        std::unique_lock<FiberMutex> lock(m_State->mutex);
+        m_State->ready.wait(lock, [this] { return m_State->value || m_State->error; });
+        if (m_State->error) std::rethrow_exception(m_State->error);
+        return std::move(*m_State->value);
+    }
+
+private:
+    friend class FiberPromise<T>;
+    using State = typename FiberPromise<T>::State;
+    explicit FiberFuture(std::shared_ptr<State> state) : m_State(std::move(state)) {}
+    std::shared_ptr<State> m_State;
+};
+
+// -----------------------------------------------------------
+long ReadRssKB() {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 6, "VmRSS:") == 0) return std::atol(line.c_str() + 6);
+    }
+    return 0;
+}
+
+double Seconds(Clock::time_point begin) {
+    return std::chrono::duration<double>(Clock::now() - begin).count();
+}
+
+// Examples rewritten for fibers: same blocking style
+int Add(int a, int b) {
+    this_fiber::SleepFor(std::chrono::milliseconds(100));   // simulate work
+    return a + b;
+}
+
+int mul(int a, int b) {
+    this_fiber::SleepFor(std::chrono::milliseconds(100));   // simulate work
+    return a * b;
+}
+
+// 2 fibers bounce control back and forth
+double FiberSwitchNs(int rounds) {
+    Scheduler scheduler;
+    auto Bounce = [rounds] { for (int i = 0; i < rounds; ++i) this_fiber::Yield(); };
+    scheduler.Spawn(Bounce);
+    scheduler.Spawn(Bounce);
+    auto begin = Clock::now();
+    scheduler.Run();
+    // every Yield = fiber → scheduler → next fiber = 2 switches
+    return Seconds(begin) * 1e9 / (2.0 * rounds * 2);
+}
+
+// 2 OS threads bounce control back and forth through a condition_variable
+double ThreadSwitchNs(int rounds) {
+    std::mutex m;
+    std::condition_variable cv;
+    int turn = 0;
+    auto Bounce = [&](int me) {
+        for (int i = 0; i < rounds; ++i) {
+            std::unique_lock<std::mutex> lock(m);
+            cv.wait(lock, [&] { return turn == me; });
+            turn = 1 - me;
+            cv.notify_one();
+        }
+    };
+    auto begin = Clock::now();
+    std::thread a(Bounce, 0), b(Bounce, 1);
+    a.join();
+    b.join();
+    return Seconds(begin) * 1e9 / (2.0 * rounds);
+}
+
+// N fibers, all blocked in SleepFor at the same moment: RSS per fiber
+void FiberMemory(int count, bool guard, std::size_t stackSize) {
+    Scheduler::Options options;
+    options.guardPage = guard;
+    options.stackSize = stackSize;
+    Scheduler scheduler(options);
+    const long before = ReadRssKB();
+    long peak = 0;
+    auto begin = Clock::now();
+    for (int i = 0; i < count; ++i) {
+        scheduler.Spawn([] { this_fiber::SleepFor(std::chrono::milliseconds(300)); });
+    }
+    scheduler.Spawn([&] {
+        this_fiber::SleepFor(std::chrono::milliseconds(100));    // everybody is asleep by now
+        peak = ReadRssKB();
+    });
+    scheduler.Run();
+    std::cout << std::left << std::setw(34)
+              << ("fibers, " + std::to_string(stackSize / 1024) + "KB stack" + (guard ? " + guard" : ""))
+              << std::right << std::setw(10) << count
+              << std::setw(14) << std::fixed << std::setprecision(2) << (peak - before) / double(count)
+              << std::setw(16) << Seconds(begin) * 1e3 << std::endl;
+}
+
+// N threads, all blocked on a condition_variable at the same moment
+void ThreadMemory(int count) {
+    std::mutex m;
+    std::condition_variable cv;
+    bool release = false;
+    int started = 0;
+    const long before = ReadRssKB();
+    auto begin = Clock::now();
+    std::vector<std::thread> threads;
+    try {
+        for (int i = 0; i < count; ++i) {
+            threads.emplace_back([&] {
+                std::unique_lock<std::mutex> lock(m);
+                ++started;
+                cv.notify_all();
+                cv.wait(lock, [&] { return release; });
+            });
+        }
+    } catch (const std::system_error &) {
+        // hit the thread limit - report what we got
+    }
+    {
+        std::unique_lock<std::mutex> lock(m);
+        cv.wait(lock, [&] { return started == static_cast<int>(threads.size()); });
+    }
+    const long peak = ReadRssKB();
+    {
+        std::lock_guard<std::mutex> lock(m);
+        release = true;
+    }
+    cv.notify_all();
+    for (auto &t : threads) t.join();
+    std::cout << std::left << std::setw(34) << "std::thread (8MB virtual stack)" << std::right
+              << std::setw(10) << threads.size()
+              << std::setw(14) << std::fixed << std::setprecision(2) << (peak - before) / double(threads.size())
+              << std::setw(16) << Seconds(begin) * 1e3 << std::endl;
+}
+
+int main() {
+    // Step 1: Add and mul "sleep" 100ms each, concurrently, on one OS thread
+    {
+        Scheduler scheduler;
+        auto begin = Clock::now();
+        scheduler.Spawn([] {
+            int sum = Add(10, 20);
+            std::cout << "Addition is : " << sum << std::endl;
+        });
+        scheduler.Spawn([] {
+            int product = mul(10, 20);
+            std::cout << "Multiplication is : " << product << std::endl;
+        });
+        scheduler.Run();
+        std::cout << "[main] both done after " << static_cast<int>(Seconds(begin) * 1e3) << " ms on one thread" << std::endl;
+    }
+
+    // Step 2: Download / ProcessData of 10_Thread_ConditionVariable_example.cpp,
+    // plus the promise/future of 8_Thread_promise.cpp - unchanged style
+    {
+        Scheduler scheduler;
+        FiberMutex mutex;
+        FiberConditionVariable cv;
+        std::deque<int> data;
+        bool finished = false;
+        FiberPromise<int> count;
+        FiberFuture<int> countFuture = count.get_future();
+
+        scheduler.Spawn([&] {                               // Operation
+            int n = countFuture.get();                      // suspends this fiber only
+            std::cout << "[Task] Count acquired: " << n << std::endl;
+        });
+        scheduler.Spawn([&] {                               // Download
+            for (int i = 0; i < 3; ++i) {
+                this_fiber::SleepFor(std::chrono::milliseconds(20));
+                {
+                    std::lock_guard<FiberMutex> lock(mutex);
+                    data.push_back(i);
+                }
+                cv.notify_one();
+            }
+            {
+                std::lock_guard<FiberMutex> lock(mutex);
+                finished = true;
+            }
+            cv.notify_one();
+        });
+        scheduler.Spawn([&] {                               // ProcessData
+            std::unique_lock<FiberMutex> lock(mutex);
+            while (true) {
+                cv.wait(lock, [&] { return !data.empty() || finished; });
+                while (!data.empty()) {
+                    std::cout << "[Processor] Processed " << data.front() << std::endl;
+                    data.pop_front();
+                }
+                if (finished) break;
+            }
+        });
+        scheduler.Spawn([&] {                               // main setting the promise
+            this_fiber::SleepFor(std::chrono::milliseconds(30));
+            count.set_value(10);
+        });
+        scheduler.Run();
+    }
+
+    // Step 3: the guard page turns a stack overflow into a clean SIGSEGV
+    // (run in a child process so this demo survives it)
+    {
+        pid_t pid = ::fork();
+        if (pid == 0) {
+            Scheduler scheduler(Scheduler::Options{16 * 1024, true});
+            std::function<int(int)> Recurse = [&](int depth) {
+                volatile char frame[512];
+                frame[0] = static_cast<char>(depth);
+                return Recurse(depth + 1) + frame[0];
+            };
+            scheduler.Spawn([&] { Recurse(0); });
+            scheduler.Run();
+            ::_exit(0);
+        }
+        int status = 0;
+        ::waitpid(pid, &status, 0);
+        std::cout << "[main] fiber overflowing a 16KB stack: "
+                  << (WIFSIGNALED(status) && WTERMSIG(status) == SIGSEGV ? "SIGSEGV on the guard page" : "no crash?")
+                  << std::endl;
+    }
+
+    // Step 4: context switch cost
+    std::cout << "\ncontext switch\n"
+              << "  fiber (" <<
+#if defined(__x86_64__)
+                 "x86-64 asm"
+#elif defined(__aarch64__)
+                 "AArch64 asm"
+#else
+                 "ucontext"
+#endif
+              << ")  : " << std::fixed << std::setprecision(1) << FiberSwitchNs(2000000) << " ns\n"
+              << "  std::thread + cv   : " << ThreadSwitchNs(100000) << " ns" << std::endl;
+
+    // Step 5: memory per blocked fiber / thread
+    std::cout << "\n" << std::left << std::setw(34) << "all blocked at once" << std::right
+              << std::setw(10) << "count" << std::setw(14) << "RSS KB/each" << std::setw(16) << "total ms" << std::endl;
+    FiberMemory(100000, false, 32 * 1024);
+    FiberMemory(25000, true, 64 * 1024);
+    ThreadMemory(2000);
+
+    return 0;
+}
+
+/* ------------------------------------------------------------------
+THEORY & KEY POINTS: Fibers (stackful coroutines)
+
+1. Why:
+   - Blocking style is easy to read: sleep, wait, get().
+   - OS threads are expensive: 8MB virtual stack, kernel structures, a
+     syscall + scheduler run for every switch (~µs). 100k threads don't fit.
+   - A fiber is a stack + saved registers; switching is a function call.
+
+2. The context switch:
+   - Callee-saved registers (x86-64: rbx rbp r12-r15 + MXCSR/x87 control;
+     AArch64: x19-x30, d8-d15) are pushed on the current stack.
+   - Save sp, load the other fiber's sp, pop its registers, `ret`.
+   - Caller-saved registers were already saved by the compiler because it
+     sees an ordinary call.
+   - A new fiber gets a fake frame whose "return address" is FiberMain.
+
+3. Stacks:
+   - mmap reserves address space; pages are committed when touched →
+     a fiber that uses 2KB of stack costs ~1 page of RAM, not 64KB.
+   - Guard page (PROT_NONE) below each stack: overflow = SIGSEGV instead
+     of silent corruption of the neighbour.
+   - Each guarded stack = 2 kernel mappings; vm.max_map_count (65530)
+     caps how many you can have → slabs without guards for huge counts.
+
+4. Fiber-aware primitives:
+   - A std::mutex / cv / future would block the whole OS thread, and with
+     it every fiber on it (and deadlock if the owner is a fiber there).
+   - The fiber versions put the fiber in a wait list and switch to the
+     scheduler; notify/unlock/set_value move it back to the ready queue.
+   - SleepFor = a timer heap; the scheduler sleeps only when nothing is ready.
+
+5. Limits:
+   - Cooperative: a fiber that computes for 1s without yielding blocks all
+     others on its thread.
+   - A real blocking syscall (read, std::this_thread::sleep_for) still
+     blocks the thread → pair fibers with non-blocking I/O (epoll/io_uring).
+   - One scheduler per OS thread here; M:N (fibers migrating between
+     threads) needs atomics in the primitives and work stealing.
+
+------------------------------------------------------------------
+
+💡 Memory Tip / Analogy
+	•	OS thread = a full-time employee with their own office (expensive, the manager (kernel) decides who works).
+	•	Fiber = a task folder on one desk: put a bookmark in it (save registers), pick up another folder.
+	•	Guard page = a sheet of glass under each folder stack - reach too far and you notice immediately.
+
+*/
@@ -0,0 +1,788 @@
+// 24_Thread_epoll_reactor.cpp
+// clang++ -std=c++17 -O2 -pthread 24_Thread_epoll_reactor.cpp -o a; ./a [connections]
+// @author :  DhiraxD
+// @brief  : Event-driven downloads: one reactor thread drives thousands of
+//           non-blocking sockets instead of one blocked thread per Download().
+//           - Reactor     : epoll + eventfd (Post from any thread) + timerfd (RunAfter)
+//           - Downloader  : non-blocking connect/send/recv state machine that
+//                           completes a std::future; the received data is
+//                           processed on a ThreadPool, never on the reactor thread
+//           - stand-in server on a local (abstract AF_UNIX) socket in a child
+//             process, with artificial latency → works offline
+//           Benchmark: 10k concurrent downloads, reactor vs thread-per-download. (Linux)
+// References:
+// https://man7.org/linux/man-pages/man7/epoll.7.html
+// https://man7.org/linux/man-pages/man2/eventfd.2.html
+// https://man7.org/linux/man-pages/man2/timerfd_create.2.html
+// https://man7.org/linux/man-pages/man7/unix.7.html
+// https://en.wikipedia.org/wiki/Reactor_pattern
+// http://www.kegel.com/c10k.html
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <vector>
+#include <deque>
+#include <queue>
+#include <unordered_map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <functional>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <stdexcept>
+#include <system_error>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cstddef>
+
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+using Clock = std::chrono::steady_clock;
+
+[[noreturn]] void ThrowErrno(const char *what, int err = errno) {
+    throw std::system_error(err, std::generic_category(), what);
+}
+
+// -----------------------------------------------------------
+// Reactor: waits for "fd is readable/writable" and calls the handler.
+// Everything except Post() and Stop() must be called on the reactor thread
+// (i.e. from inside a handler / posted task / timer).
+class Reactor {
+public:
+    using Handler = std::function<void(std::uint32_t events)>;
+    using Task = std::function<void()>;
+    using TimerId = std::uint64_t;
+
+    Reactor() {
+        m_Epoll = ::epoll_create1(EPOLL_CLOEXEC);
+        if (m_Epoll < 0) ThrowErrno("epoll_create1");
+        m_WakeFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (m_WakeFd < 0) ThrowErrno("eventfd");
+        m_TimerFd = ::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        if (m_TimerFd < 0) ThrowErrno("timerfd_create");
+
+        Add(m_WakeFd, EPOLLIN, [this](std::uint32_t) {
+            std::uint64_t n;
+            while (::read(m_WakeFd, &n, sizeof(n)) == sizeof(n)) {}
+            RunPosted();
+        });
+        Add(m_TimerFd, EPOLLIN, [this](std::uint32_t) {
+            std::uint64_t n;
+            while (::read(m_TimerFd, &n, sizeof(n)) == sizeof(n)) {}
+            RunTimers();
+        });
+    }
+    ~Reactor() {
+        ::close(m_TimerFd);
+        ::close(m_WakeFd);
+        ::close(m_Epoll);
+    }
+    Reactor(const Reactor&) = delete;
+    Reactor & operator=(const Reactor&) = delete;
+
+    void Add(int fd, std::uint32_t events, Handler handler) {
+        auto entry = std::make_shared<Entry>(Entry{std::move(handler), ++m_Generation});
+        Control(EPOLL_CTL_ADD, fd, events, entry->generation);
+        m_Handlers[fd] = std::move(entry);
+    }
+    void Modify(int fd, std::uint32_t events) {
+        Control(EPOLL_CTL_MOD, fd, events, m_Handlers.at(fd)->generation);
+    }
+    // Call before close(fd)
+    void Remove(int fd) {
+        ::epoll_ctl(m_Epoll, EPOLL_CTL_DEL, fd, nullptr);
+        m_Handlers.erase(fd);
+    }
+
+    // Thread-safe: run task on the reactor thread
+    void Post(Task task) {
+        bool wake;
+        {
+            std::lock_guard<std::mutex> lock(m_PostMutex);
+            m_Posted.push_back(std::move(task));
+            wake = !m_WakePending;
+            m_WakePending = true;
+        }
+        if (wake) {
+            std::uint64_t one = 1;
+            if (::write(m_WakeFd, &one, sizeof(one)) < 0) ThrowErrno("write eventfd");
+        }
+    }
+
+    TimerId RunAfter(Clock::duration delay, Task task) {
+        const TimerId id = ++m_TimerSeq;
+        const auto when = Clock::now() + delay;
+        m_Timers.push({when, id});
+        m_TimerTasks.emplace(id, std::move(task));
+        if (m_Timers.top().id == id) ArmTimer(when);
+        return id;
+    }
+    void Cancel(TimerId id) { m_TimerTasks.erase(id); }   // its heap entry is skipped later
+
+    // Thread-safe
+    void Stop() {
+        Post([this] { m_Stop = true; });
+    }
+
+    void Run() {
+        epoll_event events[256];
+        while (!m_Stop) {
+            int n = ::epoll_wait(m_Epoll, events, 256, -1);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                ThrowErrno("epoll_wait");
+            }
+            for (int i = 0; i < n; ++i) {
+                const int fd = static_cast<int>(events[i].data.u64 & 0xFFFFFFFF);
+                const std::uint32_t generation = static_cast<std::uint32_t>(events[i].data.u64 >> 32);
+                auto it = m_Handlers.find(fd);
+                // removed by an earlier handler in this batch, or the fd number was reused
+                if (it == m_Handlers.end() || it->second->generation != generation) continue;
+                std::shared_ptr<Entry> keepAlive = it->second;  // handler may Remove() itself
+                keepAlive->handler(events[i].events);
+            }
+        }
+    }
+
+private:
+    struct Entry {
+        Handler handler;
+        std::uint32_t generation;
+    };
+    struct Timer {
+        Clock::time_point when;
+        TimerId id;
+        bool operator>(const Timer &other) const {
+            return when != other.when ? when > other.when : id > other.id;
+        }
+    };
+
+    void Control(int op, int fd, std::uint32_t events, std::uint32_t generation) {
+        epoll_event ev{};
+        ev.events = events;
+        ev.data.u64 = (std::uint64_t(generation) << 32) | static_cast<std::uint32_t>(fd);
+        if (::epoll_ctl(m_Epoll, op, fd, &ev) < 0) ThrowErrno("epoll_ctl");
+    }
+
+    void RunPosted() {
+        std::vector<Task> tasks;
+        {
+            std::lock_guard<std::mutex> lock(m_PostMutex);
+            tasks.swap(m_Posted);
+            m_WakePending = false;
+        }
+        for (auto &task : tasks) task();
+    }
+
+    void ArmTimer(Clock::time_point when) {
+        // steady_clock is CLOCK_MONOTONIC on Linux → absolute expiry
+        const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(when.time_since_epoch()).count();
+        itimerspec spec{};
+        spec.it_value.tv_sec = ns / 1000000000;
+        spec.it_value.tv_nsec = ns % 1000000000;
+        if (spec.it_value.tv_sec == 0 && spec.it_value.tv_nsec == 0) spec.it_value.tv_nsec = 1;     // 0 = disarm
+        if (::timerfd_settime(m_TimerFd, TFD_TIMER_ABSTIME, &spec, nullptr) < 0) ThrowErrno("timerfd_settime");
+    }
+
+    void RunTimers() {
+        const auto now = Clock::now();
+        while (!m_Timers.empty() && m_Timers.top().when <= now) {
+            const TimerId id = m_Timers.top().id;
+            m_Timers.pop();
+            auto it = m_TimerTasks.find(id);
+            if (it == m_TimerTasks.end()) continue;         // cancelled
+            Task task = std::move(it->second);
+            m_TimerTasks.erase(it);
+            task();
+        }
+        while (!m_Timers.empty() && m_TimerTasks.count(m_Timers.top().id) == 0) m_Timers.pop();
+        if (!m_Timers.empty()) ArmTimer(m_Timers.top().when);
+    }
+
+    int m_Epoll = -1, m_WakeFd = -1, m_TimerFd = -1;
+    std::unordered_map<int, std::shared_ptr<Entry>> m_Handlers;
+    std::uint32_t m_Generation = 0;
+
+    std::mutex m_PostMutex;
+    std::vector<Task> m_Posted;
+    bool m_WakePending = false;
+
+    std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> m_Timers;
+    std::unordered_map<TimerId, Task> m_TimerTasks;
+    TimerId m_TimerSeq = 0;
+
+    bool m_Stop = false;
+};
+
+// -----------------------------------------------------------
+// Executor for the CPU part (ProcessData)
+class ThreadPool {
+public:
+    explicit ThreadPool(unsigned workers) {
+        for (unsigned i = 0; i < workers; ++i) {
+            m_Workers.emplace_back([this] { WorkerLoop(); });
+        }
+    }
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Stop = true;
+        }
+        m_CV.notify_all();
+        for (auto &t : m_Workers) t.join();
+    }
+
+    void Submit(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Tasks.push_back(std::move(task));
+        }
+        m_CV.notify_one();
+    }
+
+    std::size_t Size() const { return m_Workers.size(); }
+
+private:
+    void WorkerLoop() {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(m_Mutex);
+                m_CV.wait(lock, [this] { return m_Stop || !m_Tasks.empty(); });
+                if (m_Tasks.empty()) return;
+                task = std::move(m_Tasks.front());
+                m_Tasks.pop_front();
+            }
+            task();
+        }
+    }
+
+    std::mutex m_Mutex;
+    std::condition_variable m_CV;
+    std::deque<std::function<void()>> m_Tasks;
+    bool m_Stop = false;
+    std::vector<std::thread> m_Workers;
+};
+
+// -----------------------------------------------------------
+// Wire protocol of the stand-in server: client sends "GET <bytes>\n",
+// server waits `latency`, sends <bytes> of a known pattern and closes.
+inline char PatternByte(std::size_t i) { return static_cast<char>((i * 131 + 7) & 0xFF); }
+
+struct LocalAddress {
+    sockaddr_un addr{};
+    socklen_t len = 0;
+
+    // Abstract namespace (leading '\0'): no file to clean up
+    explicit LocalAddress(const std::string &name) {
+        addr.sun_family = AF_UNIX;
+        std::memcpy(addr.sun_path + 1, name.data(), std::min(name.size(), sizeof(addr.sun_path) - 1));
+        len = static_cast<socklen_t>(offsetof(sockaddr_un, sun_path) + 1 + name.size());
+    }
+    const sockaddr * Get() const { return reinterpret_cast<const sockaddr*>(&addr); }
+};
+
+class StandInServer {
+    struct Connection {
+        int fd;
+        std::string request;
+        std::size_t size = 0, sent = 0;
+    };
+
+public:
+    StandInServer(Reactor &reactor, const LocalAddress &address, Clock::duration latency)
+        : m_Reactor(reactor), m_Latency(latency) {
+        for (std::size_t i = 0; i < m_Block.size(); ++i) m_Block[i] = PatternByte(i);
+        m_Listen = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (m_Listen < 0) ThrowErrno("socket");
+        if (::bind(m_Listen, address.Get(), address.len) < 0) ThrowErrno("bind");
+        if (::listen(m_Listen, SOMAXCONN) < 0) ThrowErrno("listen");
+        m_Reactor.Add(m_Listen, EPOLLIN, [this](std::uint32_t) { Accept(); });
+    }
+
+private:
+    void Accept() {
+        while (true) {
+            int fd = ::accept4(m_Listen, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) {
+                if (errno == EMFILE || errno == ENFILE) PauseAccept();
+                return;                     // EAGAIN: backlog drained
+            }
+            auto conn = std::make_shared<Connection>(Connection{fd, {}});
+            m_Reactor.Add(fd, EPOLLIN, [this, conn](std::uint32_t) { ReadRequest(conn); });
+        }
+    }
+
+    // Out of fds: the listen fd is level-triggered and stays readable, so
+    // leaving it in epoll would spin. Take it out until a connection closes
+    // (or 10 ms pass, in case the fds are held by someone else).
+    void PauseAccept() {
+        if (m_AcceptPaused) return;
+        m_AcceptPaused = true;
+        m_Reactor.Remove(m_Listen);
+        m_Reactor.RunAfter(std::chrono::milliseconds(10), [this] { ResumeAccept(); });
+    }
+    void ResumeAccept() {
+        if (!m_AcceptPaused) return;
+        m_AcceptPaused = false;
+        m_Reactor.Add(m_Listen, EPOLLIN, [this](std::uint32_t) { Accept(); });
+    }
+
+    void ReadRequest(const std::shared_ptr<Connection> &conn) {
+        char buf[64];
+        ssize_t n = ::read(conn->fd, buf, sizeof(buf));
+        if (n < 0 && errno == EAGAIN) return;
+        if (n <= 0) return Close(conn);
+        conn->request.append(buf, n);
+        if (conn->request.find('\n') == std::string::npos) return;
+        conn->size = std::strtoull(conn->request.c_str() + 4, nullptr, 10);
+        m_Reactor.Remove(conn->fd);                     // quiet while "thinking"
+        m_Reactor.RunAfter(m_Latency, [this, conn] {
+            m_Reactor.Add(conn->fd, EPOLLOUT, [this, conn](std::uint32_t) { Write(conn); });
+        });
+    }
+
+    void Write(const std::shared_ptr<Connection> &conn) {
+        while (conn->sent < conn->size) {
+            const std::size_t offset = conn->sent % 256;     // pattern repeats every 256 bytes
+            const std::size_t chunk = std::min(conn->size - conn->sent, m_Block.size() - 256);
+            ssize_t n = ::send(conn->fd, m_Block.data() + offset, chunk, MSG_NOSIGNAL);
+            if (n < 0 && errno == EAGAIN) return;       // socket buffer full: wait for EPOLLOUT
+            if (n < 0) return Close(conn);
+            conn->sent += n;
+        }
+        Close(conn);
+    }
+
+    void Close(const std::shared_ptr<Connection> &conn) {
+        m_Reactor.Remove(conn->fd);
+        ::close(conn->fd);
+        ResumeAccept();                                 // one fd free again
+    }
+
+    Reactor &m_Reactor;
+    Clock::duration m_Latency;
+    int m_Listen = -1;
+    bool m_AcceptPaused = false;
+    std::vector<char> m_Block = std::vector<char>(64 * 1024 + 256);
+};
+
+// -----------------------------------------------------------
+// Client side: Download() without a blocked thread
+struct DownloadResult {
+    std::size_t bytes;
+    double ms;          // request → processed
+};
+
+class Downloader {
+    struct Operation {
+        int fd = -1;
+        std::size_t size;
+        std::string request;
+        std::size_t sent = 0;
+        std::vector<char> data;
+        Reactor::TimerId timeout = 0;
+        Clock::time_point start;
+        std::promise<DownloadResult> result;
+    };
+    using OperationPtr = std::shared_ptr<Operation>;
+
+public:
+    Downloader(Reactor &reactor, ThreadPool &pool, const LocalAddress &address, Clock::duration timeout)
+        : m_Reactor(reactor), m_Pool(pool), m_Address(address), m_Timeout(timeout) {}
+
+    // Thread-safe
+    std::future<DownloadResult> Get(std::size_t size) {
+        auto op = std::make_shared<Operation>();
+        op->size = size;
+        op->request = "GET " + std::to_string(size) + "\n";
+        op->start = Clock::now();
+        auto future = op->result.get_future();
+        m_Reactor.Post([this, op] {
+            op->timeout = m_Reactor.RunAfter(m_Timeout, [this, op] {
+                op->timeout = 0;
+                Fail(op, std::make_exception_ptr(std::runtime_error("download timed out")));
+            });
+            Connect(op);
+        });
+        return future;
+    }
+
+private:
+    void Connect(const OperationPtr &op) {
+        op->fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (op->fd < 0) return Fail(op, std::make_exception_ptr(std::system_error(errno, std::generic_category(), "socket")));
+        if (::connect(op->fd, m_Address.Get(), m_Address.len) < 0 && errno != EINPROGRESS) {
+            const int err = errno;
+            ::close(op->fd);
+            op->fd = -1;
+            // AF_UNIX reports a full listen backlog as EAGAIN instead of queueing
+            if (err == EAGAIN) {
+                m_Reactor.RunAfter(std::chrono::milliseconds(1), [this, op] {
+                    if (op->timeout != 0) Connect(op);
+                });
+                return;
+            }
+            return Fail(op, std::make_exception_ptr(std::system_error(err, std::generic_category(), "connect")));
+        }
+        m_Reactor.Add(op->fd, EPOLLOUT, [this, op](std::uint32_t events) { OnEvent(op, events); });
+    }
+
+    void OnEvent(const OperationPtr &op, std::uint32_t events) {
+        if (op->sent < op->request.size()) {
+            ssize_t n = ::send(op->fd, op->request.data() + op->sent, op->request.size() - op->sent, MSG_NOSIGNAL);
+            if (n < 0 && errno == EAGAIN) return;
+            if (n < 0) return Fail(op, std::make_exception_ptr(std::system_error(errno, std::generic_category(), "send")));
+            op->sent += n;
+            if (op->sent == op->request.size()) {
+                op->data.reserve(op->size);
+                m_Reactor.Modify(op->fd, EPOLLIN);
+            }
+            return;
+        }
+        (void)events;
+        while (true) {
+            ssize_t n = ::read(op->fd, m_Buffer, sizeof(m_Buffer));
+            if (n > 0) {
+                op->data.insert(op->data.end(), m_Buffer, m_Buffer + n);
+                continue;
+            }
+            if (n < 0 && errno == EAGAIN) return;       // more later
+            if (n < 0) return Fail(op, std::make_exception_ptr(std::system_error(errno, std::generic_category(), "read")));
+            return Complete(op);                        // EOF: server is done
+        }
+    }
+
+    void Release(const OperationPtr &op) {
+        if (op->timeout != 0) m_Reactor.Cancel(op->timeout);
+        op->timeout = 0;
+        if (op->fd >= 0) {
+            m_Reactor.Remove(op->fd);
+            ::close(op->fd);
+            op->fd = -1;
+        }
+    }
+
+    void Complete(const OperationPtr &op) {
+        Release(op);
+        // ProcessData: CPU work goes to the pool, the reactor keeps doing I/O
+        m_Pool.Submit([op] {
+            for (std::size_t i = 0; i < op->data.size(); ++i) {
+                if (op->data[i] != PatternByte(i)) {
+                    op->result.set_exception(std::make_exception_ptr(std::runtime_error("corrupted download")));
+                    return;
+                }
+            }
+            if (op->data.size() != op->size) {
+                op->result.set_exception(std::make_exception_ptr(std::runtime_error("short download")));
+                return;
+            }
+            const double ms = std::chrono::duration<double, std::milli>(Clock::now() - op->start).count();
+            op->result.set_value(DownloadResult{op->data.size(), ms});
+        });
+    }
+
+    void Fail(const OperationPtr &op, std::exception_ptr error) {
+        Release(op);
+        op->result.set_exception(error);
+    }
+
+    Reactor &m_Reactor;
+    ThreadPool &m_Pool;
+    LocalAddress m_Address;
+    Clock::duration m_Timeout;
+    char m_Buffer[64 * 1024];       // only touched on the reactor thread
+};
+
+// -----------------------------------------------------------
+// Baseline: the examples' style - one blocked thread per Download()
+DownloadResult BlockingDownload(const LocalAddress &address, std::size_t size) {
+    const auto start = Clock::now();
+    int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) ThrowErrno("socket");
+    while (::connect(fd, address.Get(), address.len) < 0) {
+        if (errno != EAGAIN) {
+            ::close(fd);
+            ThrowErrno("connect");
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    const std::string request = "GET " + std::to_string(size) + "\n";
+    if (::send(fd, request.data(), request.size(), MSG_NOSIGNAL) != static_cast<ssize_t>(request.size())) {
+        ::close(fd);
+        ThrowErrno("send");
+    }
+    std::vector<char> data;
+    data.reserve(size);
+    char buf[16 * 1024];
+    ssize_t n;
+    while ((n = ::read(fd, buf, sizeof(buf))) > 0) data.insert(data.end(), buf, buf + n);
+    ::close(fd);
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        if (data[i] != PatternByte(i)) throw std::runtime_error("corrupted download");
+    }
+    if (data.size() != size) throw std::runtime_error("short download");
+    return DownloadResult{data.size(), std::chrono::duration<double, std::milli>(Clock::now() - start).count()};
+}
+
+// -----------------------------------------------------------
+long ReadStatusKB(const char *key) {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    const std::size_t keyLen = std::strlen(key);
+    while (std::getline(status, line)) {
+        if (line.compare(0, keyLen, key) == 0) return std::atol(line.c_str() + keyLen);
+    }
+    return 0;
+}
+
+// Samples RSS and thread count every 5ms while a benchmark runs
+class Sampler {
+public:
+    Sampler() : m_Thread([this] {
+        while (!m_Stop.load()) {
+            m_PeakRssKB = std::max(m_PeakRssKB.load(), ReadStatusKB("VmRSS:"));
+            m_PeakThreads = std::max(m_PeakThreads.load(), ReadStatusKB("Threads:"));
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+    }) {}
+    ~Sampler() { Stop(); }
+
+    void Stop() {
+        m_Stop = true;
+        if (m_Thread.joinable()) m_Thread.join();
+    }
+    long PeakRssKB() const { return m_PeakRssKB; }
+    long PeakThreads() const { return m_PeakThreads - 1; }   // minus the sampler itself
+
+private:
+    std::atomic<bool> m_Stop{false};
+    std::atomic<long> m_PeakRssKB{0}, m_PeakThreads{0};
+    std::thread m_Thread;
+};
+
+void PrintRow(const char *name, int connections, std::size_t okCount, std::size_t bytes,
+              double seconds, std::vector<double> &latencies, const Sampler &sampler) {
+    std::sort(latencies.begin(), latencies.end());
+    const double p99 = latencies.empty() ? 0.0 : latencies[latencies.size() * 99 / 100];
+    std::cout << std::left << std::setw(22) << name << std::right
+              << std::setw(7) << connections
+              << std::setw(7) << okCount
+              << std::setw(11) << std::fixed << std::setprecision(0) << okCount / seconds
+              << std::setw(9) << std::setprecision(1) << bytes / seconds / 1e6
+              << std::setw(11) << p99
+              << std::setw(9) << sampler.PeakThreads()
+              << std::setw(10) << sampler.PeakRssKB() / 1024 << std::endl;
+}
+
+void RunReactorBenchmark(Reactor &reactor, ThreadPool &pool, const LocalAddress &address,
+                         int connections, std::size_t size) {
+    Downloader downloader(reactor, pool, address, std::chrono::seconds(30));
+    Sampler sampler;
+    const auto begin = Clock::now();
+    std::vector<std::future<DownloadResult>> results;
+    results.reserve(connections);
+    for (int i = 0; i < connections; ++i) results.push_back(downloader.Get(size));
+    std::size_t ok = 0, bytes = 0;
+    std::vector<double> latencies;
+    for (auto &f : results) {
+        try {
+            DownloadResult r = f.get();
+            ++ok;
+            bytes += r.bytes;
+            latencies.push_back(r.ms);
+        } catch (const std::exception &e) {
+            if (ok == 0) std::cerr << "  reactor download failed: " << e.what() << std::endl;
+        }
+    }
+    const double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+    sampler.Stop();
+    PrintRow("reactor (1 I/O thread)", connections, ok, bytes, seconds, latencies, sampler);
+}
+
+void RunThreadBenchmark(const LocalAddress &address, int connections, std::size_t size) {
+    Sampler sampler;
+    const auto begin = Clock::now();
+    std::vector<std::thread> threads;
+    std::vector<DownloadResult> results(connections, DownloadResult{0, 0.0});
+    for (int i = 0; i < connections; ++i) {
+        try {
+            threads.emplace_back([&, i] {
+                try {
+                    results[i] = BlockingDownload(address, size);
+                } catch (const std::exception &) {
+                    // counted as failed (bytes == 0)
+                }
+            });
+        } catch (const std::system_error &e) {
+            std::cerr << "  thread #" << i << " could not be created: " << e.what() << std::endl;
+            break;
+        }
+    }
+    for (auto &t : threads) t.join();
+    const double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+    sampler.Stop();
+    std::size_t ok = 0, bytes = 0;
+    std::vector<double> latencies;
+    for (const auto &r : results) {
+        if (r.bytes == 0) continue;
+        ++ok;
+        bytes += r.bytes;
+        latencies.push_back(r.ms);
+    }
+    PrintRow("thread-per-download", connections, ok, bytes, seconds, latencies, sampler);
+}
+
+// Raise the soft RLIMIT_NOFILE as far as the hard limit allows (default soft
+// limit is often 1024); returns how many fds this process may have open.
+// Inherited by fork() → the stand-in server gets the same limit.
+rlim_t RaiseFdLimit(rlim_t wanted) {
+    rlimit limit{};
+    if (::getrlimit(RLIMIT_NOFILE, &limit) < 0) ThrowErrno("getrlimit");
+    if (limit.rlim_cur < wanted) {
+        limit.rlim_cur = std::min(wanted, limit.rlim_max);
+        if (::setrlimit(RLIMIT_NOFILE, &limit) < 0) ThrowErrno("setrlimit");
+    }
+    return limit.rlim_cur;
+}
+
+int main(int argc, char *argv[]) {
+    int maxConnections = argc > 1 ? std::atoi(argv[1]) : 10000;
+    const std::size_t size = 16 * 1024;
+    const auto latency = std::chrono::milliseconds(20);
+
+    // Step 1: the stand-in server runs in a child process with its own reactor
+    // (and its own fd table: 10k connections need 10k fds on EACH side)
+    constexpr int SPARE_FDS = 64;                       // stdio, epoll, eventfd, timerfd, pipes...
+    const rlim_t fdLimit = RaiseFdLimit(rlim_t(maxConnections) + SPARE_FDS);
+    if (rlim_t(maxConnections) + SPARE_FDS > fdLimit) {
+        maxConnections = std::max(1, int(fdLimit) - SPARE_FDS);
+        std::cout << "[main] RLIMIT_NOFILE hard limit is " << fdLimit << " → " << maxConnections
+                  << " connections max" << std::endl;
+    }
+    const LocalAddress address("lesson24_" + std::to_string(::getpid()));
+    int ready[2];
+    if (::pipe(ready) < 0) ThrowErrno("pipe");
+    pid_t server = ::fork();
+    if (server < 0) ThrowErrno("fork");
+    if (server == 0) {
+        ::close(ready[0]);
+        Reactor reactor;
+        StandInServer stand(reactor, address, latency);
+        if (::write(ready[1], "1", 1) != 1) ::_exit(1);
+        ::close(ready[1]);
+        reactor.Run();                  // until SIGTERM
+        ::_exit(0);
+    }
+    ::close(ready[1]);
+    char byte;
+    if (::read(ready[0], &byte, 1) != 1) {
+        std::cerr << "stand-in server failed to start" << std::endl;
+        return 1;
+    }
+    ::close(ready[0]);
+
+    // Step 2: one reactor thread for all sockets + a pool for ProcessData
+    Reactor reactor;
+    std::thread ioThread([&reactor] { reactor.Run(); });
+    ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()));
+
+    // Step 3: three Download()s in flight at once, no thread blocked on any
+    {
+        Downloader downloader(reactor, pool, address, std::chrono::seconds(5));
+        auto begin = Clock::now();
+        auto a = downloader.Get(1000);
+        auto b = downloader.Get(100000);
+        auto c = downloader.Get(1000000);
+        std::cout << "[main] downloaded " << a.get().bytes << ", " << b.get().bytes << " and "
+                  << c.get().bytes << " bytes in "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - begin).count()
+                  << " ms (server latency " << latency.count() << " ms)" << std::endl;
+
+        // timeouts come from the same reactor (timerfd)
+        Downloader impatient(reactor, pool, address, std::chrono::milliseconds(5));
+        try {
+            impatient.Get(1000).get();
+        } catch (const std::exception &e) {
+            std::cout << "[main] 5 ms timeout: " << e.what() << std::endl;
+        }
+    }
+
+    // Step 4: concurrent downloads, reactor vs one thread each
+    std::cout << "\n" << size / 1024 << "KB per download, " << latency.count() << " ms server latency\n"
+              << std::left << std::setw(22) << "mode" << std::right
+              << std::setw(7) << "conns" << std::setw(7) << "ok" << std::setw(11) << "dl/s"
+              << std::setw(9) << "MB/s" << std::setw(11) << "p99 ms" << std::setw(9) << "threads"
+              << std::setw(10) << "RSS MB" << std::endl;
+    for (int connections : {100, 1000, maxConnections}) {
+        if (connections > maxConnections) continue;
+        RunReactorBenchmark(reactor, pool, address, connections, size);
+        RunThreadBenchmark(address, connections, size);
+    }
+
+    reactor.Stop();
+    ioThread.join();
+    ::kill(server, SIGTERM);
+    ::waitpid(server, nullptr, 0);
+    return 0;
+}
+
+/* ------------------------------------------------------------------
+THEORY & KEY POINTS: Reactor (event loop) for network I/O
+
+1. Thread-per-download:
+   - Simple blocking code, but a thread that waits on the network does
+     nothing except hold ~8MB of virtual stack + kernel task + scheduling.
+   - 10k downloads = 10k threads: thread limits, memory, context switches.
+
+2. Reactor:
+   - Sockets are non-blocking: read/send return EAGAIN instead of waiting.
+   - epoll_wait() returns the fds that are READY; the loop calls a handler
+     per fd. One thread serves all connections.
+   - Each download is a small state machine: connect → send request →
+     read until EOF → complete the promise.
+
+3. Three kinds of wake-ups, all fds in the same epoll set:
+   - sockets  : data / buffer space / errors
+   - eventfd  : Post(task) from other threads (wake only once per batch)
+   - timerfd  : RunAfter() timeouts and retries (one fd + min-heap)
+
+4. Rules:
+   - Never block or burn CPU in a handler: every other connection waits.
+     → hand data to a ThreadPool (ProcessData) and return.
+   - A handler may close/remove fds → generation number in epoll data,
+     keep the handler alive while it runs.
+   - AF_UNIX connect with a full backlog fails with EAGAIN → retry later.
+   - Every connection is an fd: raise RLIMIT_NOFILE (soft limit is often
+     1024). accept() failing with EMFILE leaves the level-triggered listen
+     fd readable → remove it from epoll until an fd is closed, or spin.
+
+5. Results to expect:
+   - Throughput is similar when the network is the bottleneck; the win is
+     resources: 1 I/O thread + pool instead of N threads and N stacks,
+     and no thread limit on the number of concurrent downloads.
+
+------------------------------------------------------------------
+
+💡 Memory Tip / Analogy
+	•	Thread-per-download = one waiter per table who stands there until the food is cooked.
+	•	Reactor = one waiter with a buzzer board (epoll): goes only to tables that buzzed.
+	•	eventfd = the kitchen bell; timerfd = the kitchen timer - both ring on the same board.
+
+*/
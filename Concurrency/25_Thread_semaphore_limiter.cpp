@@ -0,0 +1,453 @@
+// 25_Thread_semaphore_limiter.cpp
+// clang++ -std=c++17 -O2 -pthread 25_Thread_semaphore_limiter.cpp -o a; ./a [requests]
+// @author :  DhiraxD
+// @brief  : Bounding std::async-style launches under a burst.
+//           - CountingSemaphore : atomic CAS fast path, futex park/wake slow path
+//           - BoundedAsync      : async-like Launch() with a cap on in-flight tasks
+//                                 per resource class ("disk", "network", ...);
+//                                 overflow is queued (caller waits when the queue
+//                                 is full) or rejected once the queue is full
+//           Benchmark: 100k-request burst - unbounded std::async vs BoundedAsync
+//           (peak threads, failures, latency). (Linux: futex)
+// References:
+// https://en.cppreference.com/w/cpp/thread/counting_semaphore
+// https://man7.org/linux/man-pages/man2/futex.2.html
+// https://en.cppreference.com/w/cpp/thread/async
+// https://en.wikipedia.org/wiki/Semaphore_(programming)
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <functional>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <stdexcept>
+#include <system_error>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+using Clock = std::chrono::steady_clock;
+
+// -----------------------------------------------------------
+// Private futex: the waiters are threads of this process only
+int FutexWait(std::atomic<std::int32_t> *addr, std::int32_t expected, const timespec *timeout) {
+    return static_cast<int>(::syscall(SYS_futex, reinterpret_cast<std::int32_t*>(addr), FUTEX_WAIT_PRIVATE,
+                                      expected, timeout, nullptr, 0));
+}
+
+void FutexWake(std::atomic<std::int32_t> *addr, int count) {
+    ::syscall(SYS_futex, reinterpret_cast<std::int32_t*>(addr), FUTEX_WAKE_PRIVATE, count, nullptr, nullptr, 0);
+}
+
+// Same interface as C++20 std::counting_semaphore (acquire/release/try_*)
+class CountingSemaphore {
+public:
+    explicit CountingSemaphore(std::int32_t initial) : m_Count(initial) {}
+    CountingSemaphore(const CountingSemaphore&) = delete;
+    CountingSemaphore & operator=(const CountingSemaphore&) = delete;
+
+    // Fast path: one CAS, no syscall
+    bool try_acquire() {
+        std::int32_t count = m_Count.load(std::memory_order_relaxed);
+        while (count > 0) {
+            if (m_Count.compare_exchange_weak(count, count - 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void acquire() {
+        if (try_acquire()) return;
+        m_Waiters.fetch_add(1);                     // seq_cst: pairs with release()
+        while (!try_acquire()) {
+            FutexWait(&m_Count, 0, nullptr);        // sleeps only while the count is still 0
+        }
+        m_Waiters.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    template <typename Rep, typename Period>
+    bool try_acquire_for(std::chrono::duration<Rep, Period> timeout) {
+        if (try_acquire()) return true;
+        const auto deadline = Clock::now() + timeout;
+        m_Waiters.fetch_add(1);
+        bool acquired = false;
+        while (!(acquired = try_acquire())) {
+            const auto left = deadline - Clock::now();
+            if (left <= Clock::duration::zero()) break;
+            const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(left).count();
+            timespec ts{static_cast<time_t>(ns / 1000000000), static_cast<long>(ns % 1000000000)};
+            FutexWait(&m_Count, 0, &ts);
+        }
+        m_Waiters.fetch_sub(1, std::memory_order_relaxed);
+        return acquired;
+    }
+
+    void release(std::int32_t n = 1) {
+        m_Count.fetch_add(n);                       // seq_cst: publish before looking for sleepers
+        if (m_Waiters.load() > 0) FutexWake(&m_Count, n);
+    }
+
+private:
+    std::atomic<std::int32_t> m_Count;
+    std::atomic<std::int32_t> m_Waiters{0};
+};
+
+// Textbook version for comparison: every operation takes the mutex
+class MutexSemaphore {
+public:
+    explicit MutexSemaphore(int initial) : m_Count(initial) {}
+
+    void acquire() {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_CV.wait(lock, [this] { return m_Count > 0; });
+        --m_Count;
+    }
+    void release() {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            ++m_Count;
+        }
+        m_CV.notify_one();
+    }
+
+private:
+    std::mutex m_Mutex;
+    std::condition_variable m_CV;
+    int m_Count;
+};
+
+// -----------------------------------------------------------
+// What to do with a launch when all slots of its class are busy
+enum class Overflow {
+    Wait,       // queue it; if the queue is full the CALLER blocks (back-pressure)
+    Reject      // queue it; if the queue is full Launch() throws
+};
+
+struct ResourceLimits {
+    std::string name;
+    int maxInFlight;            // = max threads for this class
+    std::size_t maxQueued;
+    Overflow overflow;
+};
+
+// std::async(std::launch::async, f, args...) with limits.
+// A finished task's thread picks up the next queued task of its class, so
+// threads are created only while the class is below maxInFlight.
+class BoundedAsync {
+    struct ResourceClass {
+        explicit ResourceClass(const ResourceLimits &l)
+            : limits(l), slots(l.maxInFlight), space(static_cast<std::int32_t>(l.maxQueued)) {}
+
+        ResourceLimits limits;
+        CountingSemaphore slots;            // free in-flight slots
+        CountingSemaphore space;            // free queue entries
+        std::mutex mutex;                   // guards queue + the slot/queue decision
+        std::deque<std::function<void()>> queue;
+        std::atomic<std::uint64_t> rejected{0};
+    };
+
+public:
+    explicit BoundedAsync(const std::vector<ResourceLimits> &limits) {
+        for (const auto &l : limits) {
+            if (l.maxInFlight <= 0) throw std::invalid_argument(l.name + ": maxInFlight must be > 0");
+            if (l.overflow == Overflow::Wait && l.maxQueued == 0) {
+                throw std::invalid_argument(l.name + ": Overflow::Wait needs a queue");
+            }
+            m_Classes.push_back(std::make_unique<ResourceClass>(l));
+        }
+    }
+
+    // Waits for every launched task, like the destructor of std::async's futures
+    ~BoundedAsync() {
+        std::unique_lock<std::mutex> lock(m_ThreadsMutex);
+        m_ThreadsDone.wait(lock, [this] { return m_Threads == 0; });
+    }
+    BoundedAsync(const BoundedAsync&) = delete;
+    BoundedAsync & operator=(const BoundedAsync&) = delete;
+
+    template <typename F, typename... Args>
+    auto Launch(std::size_t resource, F &&f, Args&&... args)
+        -> std::future<std::invoke_result_t<std::decay_t<F>, std::decay_t<Args>...>> {
+        using R = std::invoke_result_t<std::decay_t<F>, std::decay_t<Args>...>;
+        auto task = std::make_shared<std::packaged_task<R()>>(
+            [f = std::forward<F>(f), args = std::make_tuple(std::forward<Args>(args)...)]() mutable {
+                return std::apply(std::move(f), std::move(args));
+            });
+        auto result = task->get_future();
+        Enqueue(*m_Classes.at(resource), [task] { (*task)(); });
+        return result;
+    }
+
+    std::uint64_t Rejected(std::size_t resource) const { return m_Classes.at(resource)->rejected; }
+
+private:
+    void Enqueue(ResourceClass &c, std::function<void()> job) {
+        {
+            std::lock_guard<std::mutex> lock(c.mutex);
+            if (c.slots.try_acquire()) return StartThread(c, std::move(job));
+        }
+        if (c.limits.overflow == Overflow::Wait) {
+            c.space.acquire();                          // back-pressure on the caller
+        } else if (!c.space.try_acquire()) {
+            ++c.rejected;
+            throw std::system_error(std::make_error_code(std::errc::resource_unavailable_try_again),
+                                    "BoundedAsync: '" + c.limits.name + "' is full");
+        }
+        std::lock_guard<std::mutex> lock(c.mutex);
+        if (c.slots.try_acquire()) {                    // a slot freed up meanwhile
+            c.space.release();
+            return StartThread(c, std::move(job));
+        }
+        c.queue.push_back(std::move(job));
+    }
+
+    // Called with c.mutex held and one slot acquired
+    void StartThread(ResourceClass &c, std::function<void()> job) {
+        {
+            std::lock_guard<std::mutex> lock(m_ThreadsMutex);
+            ++m_Threads;
+        }
+        try {
+            std::thread([this, &c, job = std::move(job)]() mutable { Worker(c, std::move(job)); }).detach();
+        } catch (...) {
+            c.slots.release();
+            std::lock_guard<std::mutex> lock(m_ThreadsMutex);
+            --m_Threads;
+            throw;
+        }
+    }
+
+    void Worker(ResourceClass &c, std::function<void()> job) {
+        while (true) {
+            job();                                      // exceptions end up in the future
+            std::lock_guard<std::mutex> lock(c.mutex);
+            if (c.queue.empty()) {
+                c.slots.release();
+                break;
+            }
+            job = std::move(c.queue.front());
+            c.queue.pop_front();
+            c.space.release();                          // wakes one waiting caller
+        }
+        std::lock_guard<std::mutex> lock(m_ThreadsMutex);
+        --m_Threads;
+        m_ThreadsDone.notify_all();                     // last access to *this
+    }
+
+    std::vector<std::unique_ptr<ResourceClass>> m_Classes;
+    std::mutex m_ThreadsMutex;
+    std::condition_variable m_ThreadsDone;
+    int m_Threads = 0;
+};
+
+// -----------------------------------------------------------
+// The request handler of the burst: waits for the backend, then 2ms of I/O.
+// The burst hits while the backend is stalled, so requests pile up.
+std::atomic<int> g_Running{0};
+std::atomic<int> g_PeakRunning{0};
+std::shared_future<void> g_BackendUp;
+
+int Download(int id) {
+    int now = ++g_Running;
+    int peak = g_PeakRunning.load();
+    while (now > peak && !g_PeakRunning.compare_exchange_weak(peak, now)) {}
+    if (g_BackendUp.valid()) g_BackendUp.wait();
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    --g_Running;
+    return id;
+}
+
+struct BurstResult {
+    std::size_t ok = 0, failed = 0;
+    double seconds = 0, launchSeconds = 0;
+    std::vector<double> latencyMs;
+};
+
+void Print(const char *name, const BurstResult &r) {
+    std::vector<double> lat = r.latencyMs;
+    std::sort(lat.begin(), lat.end());
+    auto Pct = [&](double p) { return lat.empty() ? 0.0 : lat[static_cast<std::size_t>(p * (lat.size() - 1))]; };
+    std::cout << std::left << std::setw(30) << name << std::right
+              << std::setw(8) << r.ok << std::setw(8) << r.failed
+              << std::setw(9) << g_PeakRunning
+              << std::setw(10) << std::fixed << std::setprecision(2) << r.launchSeconds
+              << std::setw(9) << r.seconds
+              << std::setw(10) << std::setprecision(1) << Pct(0.5)
+              << std::setw(10) << Pct(0.99) << std::endl;
+}
+
+// Every request arrives at t=0, the backend comes back after `stall`;
+// latency = arrival → result available
+template <typename LaunchFn>
+BurstResult Burst(int requests, std::chrono::milliseconds stall, LaunchFn launch) {
+    BurstResult r;
+    std::vector<std::future<int>> futures;
+    futures.reserve(requests);
+    g_PeakRunning = 0;
+    std::promise<void> backend;
+    g_BackendUp = backend.get_future().share();
+    std::thread recovery([&backend, stall] {
+        std::this_thread::sleep_for(stall);
+        backend.set_value();
+    });
+    const auto begin = Clock::now();
+    for (int i = 0; i < requests; ++i) {
+        try {
+            futures.push_back(launch(i));
+        } catch (const std::system_error &) {
+            ++r.failed;
+        }
+    }
+    r.launchSeconds = std::chrono::duration<double>(Clock::now() - begin).count();
+    for (auto &f : futures) {
+        try {
+            f.get();
+            ++r.ok;
+            r.latencyMs.push_back(std::chrono::duration<double, std::milli>(Clock::now() - begin).count());
+        } catch (const std::exception &) {
+            ++r.failed;
+        }
+    }
+    r.seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+    recovery.join();
+    g_BackendUp = {};
+    return r;
+}
+
+template <typename Semaphore>
+double SemaphoreNs(int threads, int permits, int opsPerThread) {
+    Semaphore sem(permits);
+    std::vector<std::thread> workers;
+    const auto begin = Clock::now();
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&] {
+            for (int i = 0; i < opsPerThread; ++i) {
+                sem.acquire();
+                sem.release();
+            }
+        });
+    }
+    for (auto &w : workers) w.join();
+    return std::chrono::duration<double, std::nano>(Clock::now() - begin).count() / (double(threads) * opsPerThread);
+}
+
+int main(int argc, char *argv[]) {
+    const int requests = argc > 1 ? std::atoi(argv[1]) : 100000;
+
+    // Step 1: the semaphore itself
+    std::cout << "acquire+release (ns/op)       futex sem   mutex+cv" << std::endl;
+    std::cout << "  1 thread, 1 permit       " << std::fixed << std::setprecision(1)
+              << std::setw(12) << SemaphoreNs<CountingSemaphore>(1, 1, 2000000)
+              << std::setw(11) << SemaphoreNs<MutexSemaphore>(1, 1, 2000000) << std::endl;
+    std::cout << "  8 threads, 2 permits     "
+              << std::setw(12) << SemaphoreNs<CountingSemaphore>(8, 2, 200000)
+              << std::setw(11) << SemaphoreNs<MutexSemaphore>(8, 2, 200000) << std::endl;
+    {
+        CountingSemaphore sem(0);
+        auto begin = Clock::now();
+        bool got = sem.try_acquire_for(std::chrono::milliseconds(20));
+        std::cout << "  try_acquire_for(20ms) on 0 permits: " << (got ? "acquired?" : "timed out") << " after "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - begin).count()
+                  << " ms" << std::endl;
+    }
+
+    // Step 2: resource classes - at most 4 disk tasks and 256 network tasks at once
+    enum : std::size_t { Disk = 0, Network = 1 };
+    {
+        BoundedAsync limiter({{"disk", 4, 64, Overflow::Wait}, {"network", 256, 1000000, Overflow::Wait}});
+        auto f1 = limiter.Launch(Disk, [](int a, int b) { return a + b; }, 10, 20);
+        auto f2 = limiter.Launch(Network, Download, 7);
+        auto f3 = limiter.Launch(Disk, [] { throw std::runtime_error("disk full"); });
+        std::cout << "\n[main] Add = " << f1.get() << ", Download = " << f2.get();
+        try {
+            f3.get();
+        } catch (const std::exception &e) {
+            std::cout << ", failed task: " << e.what();
+        }
+        std::cout << std::endl;
+    }
+
+    // Step 3: the burst. The backend is stalled for 300ms, then every
+    // request is a 2ms Download()
+    const auto stall = std::chrono::milliseconds(300);
+    std::cout << "\n" << requests << " requests at once, backend stalled " << stall.count() << "ms, then 2ms each\n"
+              << std::left << std::setw(30) << "launcher" << std::right
+              << std::setw(8) << "ok" << std::setw(8) << "failed" << std::setw(9) << "running"
+              << std::setw(10) << "launch s" << std::setw(9) << "total s"
+              << std::setw(10) << "p50 ms" << std::setw(10) << "p99 ms" << std::endl;
+    {
+        BoundedAsync limiter({{"network", 256, static_cast<std::size_t>(requests), Overflow::Wait}});
+        BurstResult r = Burst(requests, stall, [&](int i) { return limiter.Launch(0, Download, i); });
+        Print("BoundedAsync 256, queue all", r);
+    }
+    {
+        BoundedAsync limiter({{"network", 256, 1024, Overflow::Wait}});
+        BurstResult r = Burst(requests, stall, [&](int i) { return limiter.Launch(0, Download, i); });
+        Print("BoundedAsync 256, queue 1024", r);
+    }
+    {
+        BoundedAsync limiter({{"api", 256, 10000, Overflow::Reject}});
+        BurstResult r = Burst(requests, stall, [&](int i) { return limiter.Launch(0, Download, i); });
+        Print("BoundedAsync 256, reject>10k", r);
+    }
+    {
+        // The unprotected pattern of 3/6/7: one thread per request, no limit.
+        // Failures are std::system_error from std::async when the OS says no.
+        BurstResult r = Burst(requests, stall, [](int i) { return std::async(std::launch::async, Download, i); });
+        Print("std::async (unbounded)", r);
+    }
+
+    return 0;
+}
+
+/* ------------------------------------------------------------------
+THEORY & KEY POINTS: Semaphores and bounded launching
+
+1. The problem:
+   - std::async(std::launch::async, ...) = one new thread per call.
+   - A burst of 100k calls → tens of thousands of threads: thread limit
+     (EAGAIN → std::system_error), 8MB stack mappings each, scheduler thrash.
+   - Worse: every queued request gets SLOWER - they all share the CPU.
+
+2. Counting semaphore:
+   - A counter of permits: acquire() takes one (waits at 0), release() returns one.
+   - Fast path = CAS on an atomic: no syscall when a permit is free.
+   - Slow path = futex: sleep in the kernel until the counter changes;
+     FUTEX_WAIT re-checks the value atomically → no lost wake-up.
+   - release() only calls FUTEX_WAKE when someone is registered as waiting.
+
+3. BoundedAsync:
+   - slots semaphore = max tasks in flight (= max threads) per class.
+   - space semaphore = max queued tasks; when it is empty:
+       Overflow::Wait   → caller blocks (back-pressure to the producer)
+       Overflow::Reject → throw right away (load shedding: fail fast)
+   - A finishing thread takes the next queued task → threads are reused.
+   - Classes keep slow disk work from taking the slots of network work.
+
+4. Choosing the limit:
+   - CPU-bound: about hardware_concurrency().
+   - I/O-bound: in-flight ≈ throughput × latency (Little's law).
+
+------------------------------------------------------------------
+
+💡 Memory Tip / Analogy
+	•	Semaphore = the number of free tables in a restaurant.
+	•	Overflow::Wait = guests wait at the door; Overflow::Reject = "sorry, we're full".
+	•	Unbounded std::async = seating everyone who arrives, even when the kitchen is on fire.
+
+*/
@@ -0,0 +1,367 @@
+// 26_Thread_barrier_latch.cpp
+// clang++ -std=c++20 -O2 -pthread 26_Thread_barrier_latch.cpp -o a; ./a
+// @author :  DhiraxD
+// @brief  : Phase synchronization for long-lived workers, instead of
+//           join() + creating new threads for every phase (5_Thread_mutex.cpp).
+//           - SenseBarrier : central counter + episode number (sense reversal)
+//           - TreeBarrier  : combining tree, fan-in 4 → no single hot counter
+//           - Latch        : one-shot countdown (count_down / wait)
+//           All wait by spinning briefly, then parking on a futex.
+//           Benchmark: barrier episodes/sec at 2..64 threads vs std::barrier
+//           and vs join/recreate. (C++20 only for the std::barrier comparison; Linux: futex)
+// References:
+// https://en.cppreference.com/w/cpp/thread/barrier
+// https://en.cppreference.com/w/cpp/thread/latch
+// https://www.cs.rochester.edu/u/scott/papers/1991_TOCS_synch.pdf  (Mellor-Crummey & Scott)
+// https://man7.org/linux/man-pages/man2/futex.2.html
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <thread>
+#include <barrier>
+#include <atomic>
+#include <chrono>
+#include <numeric>
+#include <climits>
+#include <cstdint>
+
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+// -----------------------------------------------------------
+inline void CpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+void FutexWait(std::atomic<std::uint32_t> *addr, std::uint32_t expected) {
+    ::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(addr), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+}
+
+void FutexWakeAll(std::atomic<std::uint32_t> *addr) {
+    ::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(addr), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+}
+
+// Spinning only helps when the thread we wait for is RUNNING on another core.
+// With more participants than cores it just burns the time slice they need.
+std::uint32_t DefaultSpin(std::uint32_t participants) {
+    return participants <= std::thread::hardware_concurrency() ? 4000 : 0;
+}
+
+// Returns once word != old: spin, then yield a few times, then sleep in the kernel
+void WaitWhileEqual(std::atomic<std::uint32_t> &word, std::uint32_t old,
+                    std::atomic<std::uint32_t> &sleepers, std::uint32_t spin) {
+    for (std::uint32_t i = 0; i < spin; ++i) {
+        if (word.load(std::memory_order_acquire) != old) return;
+        CpuRelax();
+    }
+    for (int i = 0; i < 4; ++i) {
+        if (word.load(std::memory_order_acquire) != old) return;
+        std::this_thread::yield();
+    }
+    sleepers.fetch_add(1);                  // seq_cst: pairs with Wake()
+    while (word.load(std::memory_order_acquire) == old) FutexWait(&word, old);
+    sleepers.fetch_sub(1, std::memory_order_relaxed);
+}
+
+// Call after changing word (with a seq_cst RMW)
+void Wake(std::atomic<std::uint32_t> &word, std::atomic<std::uint32_t> &sleepers) {
+    if (sleepers.load() > 0) FutexWakeAll(&word);  // no syscall if everybody is still spinning
+}
+
+struct NoCompletion {
+    void operator()() {}
+};
+
+// -----------------------------------------------------------
+// Central barrier. The last thread to arrive resets the counter and bumps the
+// episode number; waiters watch the episode (its lowest bit is the classic
+// "sense"). The counter can be reused immediately → no second phase needed.
+template <typename Completion = NoCompletion>
+class SenseBarrier {
+public:
+    explicit SenseBarrier(std::uint32_t participants, Completion completion = Completion())
+        : m_Participants(participants), m_Spin(DefaultSpin(participants)),
+          m_Completion(std::move(completion)), m_Remaining(participants) {}
+    SenseBarrier(const SenseBarrier&) = delete;
+    SenseBarrier & operator=(const SenseBarrier&) = delete;
+
+    void arrive_and_wait() {
+        const std::uint32_t episode = m_Episode.load(std::memory_order_acquire);
+        if (m_Remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            m_Completion();                                         // everybody else is waiting
+            m_Remaining.store(m_Participants, std::memory_order_relaxed);
+            m_Episode.fetch_add(1);                                 // release all
+            Wake(m_Episode, m_Sleepers);
+        } else {
+            WaitWhileEqual(m_Episode, episode, m_Sleepers, m_Spin);
+        }
+    }
+
+private:
+    const std::uint32_t m_Participants;
+    const std::uint32_t m_Spin;
+    Completion m_Completion;
+    alignas(64) std::atomic<std::uint32_t> m_Remaining;
+    alignas(64) std::atomic<std::uint32_t> m_Episode{0};
+    std::atomic<std::uint32_t> m_Sleepers{0};
+};
+
+// -----------------------------------------------------------
+// Combining tree: threads arrive at a leaf (fanIn threads per leaf), the
+// last arriver at a node continues to its parent, the last arriver at the
+// root ends the episode. Each counter is touched by at most fanIn threads.
+template <typename Completion = NoCompletion>
+class TreeBarrier {
+    struct alignas(64) Node {
+        std::atomic<std::uint32_t> remaining{0};
+        std::uint32_t count = 0;
+        int parent = -1;
+    };
+
+public:
+    explicit TreeBarrier(std::uint32_t participants, std::uint32_t fanIn = 4, Completion completion = Completion())
+        : m_FanIn(fanIn), m_Spin(DefaultSpin(participants)), m_Completion(std::move(completion)) {
+        // level by level, leaves first: node i of a level has min(fanIn, rest) children
+        std::vector<std::pair<std::size_t, std::size_t>> levels;    // [begin, end) in m_Nodes
+        std::uint32_t children = participants;
+        std::size_t total = 0;
+        do {
+            const std::uint32_t nodes = (children + fanIn - 1) / fanIn;
+            levels.emplace_back(total, total + nodes);
+            total += nodes;
+            children = nodes;
+        } while (children > 1);
+        m_Nodes = std::vector<Node>(total);
+
+        children = participants;
+        for (std::size_t l = 0; l < levels.size(); ++l) {
+            for (std::size_t i = levels[l].first; i < levels[l].second; ++i) {
+                const std::uint32_t index = static_cast<std::uint32_t>(i - levels[l].first);
+                m_Nodes[i].count = std::min(fanIn, children - index * fanIn);
+                m_Nodes[i].remaining.store(m_Nodes[i].count, std::memory_order_relaxed);
+                if (l + 1 < levels.size()) m_Nodes[i].parent = static_cast<int>(levels[l + 1].first + index / fanIn);
+            }
+            children = static_cast<std::uint32_t>(levels[l].second - levels[l].first);
+        }
+    }
+    TreeBarrier(const TreeBarrier&) = delete;
+    TreeBarrier & operator=(const TreeBarrier&) = delete;
+
+    // id = 0 .. participants-1, fixed per thread
+    void arrive_and_wait(std::uint32_t id) {
+        const std::uint32_t episode = m_Episode.load(std::memory_order_acquire);
+        int node = static_cast<int>(id / m_FanIn);
+        while (true) {
+            Node &n = m_Nodes[node];
+            if (n.remaining.fetch_sub(1, std::memory_order_acq_rel) != 1) break;
+            // last one here: reset for the next episode, carry the arrival upwards
+            n.remaining.store(n.count, std::memory_order_relaxed);
+            if (n.parent < 0) {
+                m_Completion();
+                m_Episode.fetch_add(1);
+                Wake(m_Episode, m_Sleepers);
+                return;
+            }
+            node = n.parent;
+        }
+        WaitWhileEqual(m_Episode, episode, m_Sleepers, m_Spin);
+    }
+
+private:
+    const std::uint32_t m_FanIn;
+    const std::uint32_t m_Spin;
+    Completion m_Completion;
+    std::vector<Node> m_Nodes;
+    alignas(64) std::atomic<std::uint32_t> m_Episode{0};
+    std::atomic<std::uint32_t> m_Sleepers{0};
+};
+
+// -----------------------------------------------------------
+// One-shot: count_down() by producers, wait() by anyone; cannot be reset
+class Latch {
+public:
+    explicit Latch(std::uint32_t count) : m_Count(count) {}
+    Latch(const Latch&) = delete;
+    Latch & operator=(const Latch&) = delete;
+
+    void count_down(std::uint32_t n = 1) {
+        if (m_Count.fetch_sub(n) == n) Wake(m_Count, m_Sleepers);
+    }
+    bool try_wait() const { return m_Count.load(std::memory_order_acquire) == 0; }
+    void wait() {
+        std::uint32_t count;
+        while ((count = m_Count.load(std::memory_order_acquire)) != 0) {
+            WaitWhileEqual(m_Count, count, m_Sleepers, 4000);
+        }
+    }
+    void arrive_and_wait(std::uint32_t n = 1) {
+        count_down(n);
+        wait();
+    }
+
+private:
+    std::atomic<std::uint32_t> m_Count;
+    std::atomic<std::uint32_t> m_Sleepers{0};
+};
+
+// -----------------------------------------------------------
+// Benchmarks: every thread does `episodes` rounds of (tiny work + barrier)
+std::atomic<std::uint64_t> g_Sink{0};
+
+inline void PhaseWork(std::uint64_t &x) {
+    for (int i = 0; i < 16; ++i) x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+}
+
+template <typename ArriveFn>
+double EpisodesPerSec(std::uint32_t threads, std::uint32_t episodes, ArriveFn arrive) {
+    std::vector<std::thread> workers;
+    Latch started(threads + 1);
+    Clock::time_point begin;
+    for (std::uint32_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            std::uint64_t x = t;
+            started.arrive_and_wait();
+            for (std::uint32_t e = 0; e < episodes; ++e) {
+                PhaseWork(x);
+                arrive(t);
+            }
+            g_Sink.store(x, std::memory_order_relaxed);
+        });
+    }
+    begin = Clock::now();
+    started.arrive_and_wait();
+    for (auto &w : workers) w.join();
+    return episodes / std::chrono::duration<double>(Clock::now() - begin).count();
+}
+
+// The 5_Thread_mutex.cpp way: a new set of threads per phase
+double JoinRecreatePerSec(std::uint32_t threads, std::uint32_t episodes) {
+    const auto begin = Clock::now();
+    for (std::uint32_t e = 0; e < episodes; ++e) {
+        std::vector<std::thread> workers;
+        for (std::uint32_t t = 0; t < threads; ++t) {
+            workers.emplace_back([t] {
+                std::uint64_t x = t;
+                PhaseWork(x);
+                g_Sink.store(x, std::memory_order_relaxed);
+            });
+        }
+        for (auto &w : workers) w.join();
+    }
+    return episodes / std::chrono::duration<double>(Clock::now() - begin).count();
+}
+
+int main() {
+    // Step 1: long-lived workers run phases: Download → (barrier) → ProcessData → (barrier) → ...
+    {
+        const std::uint32_t workers = 4;
+        const std::uint32_t rounds = 3;
+        std::vector<std::uint64_t> downloaded(workers), processed(workers);
+        std::uint32_t phase = 0;
+
+        // The completion step runs once per episode, on the last thread to
+        // arrive, while all others are still waiting → safe to touch shared state
+        auto endOfPhase = [&] {
+            if (phase++ % 2 == 0) return;                   // end of Download: nothing to merge
+            const std::uint64_t total = std::accumulate(processed.begin(), processed.end(), std::uint64_t(0));
+            std::cout << "[barrier] round " << phase / 2 - 1 << " processed total = " << total << std::endl;
+        };
+        SenseBarrier<decltype(endOfPhase)> barrier(workers, endOfPhase);
+        Latch finished(workers);
+
+        std::vector<std::thread> pool;
+        for (std::uint32_t w = 0; w < workers; ++w) {
+            pool.emplace_back([&, w] {
+                for (std::uint32_t r = 0; r < rounds; ++r) {
+                    downloaded[w] = 1000 * (r + 1) + w;     // Download phase
+                    barrier.arrive_and_wait();
+                    processed[w] = downloaded[(w + 1) % workers];  // ProcessData reads a neighbour's data
+                    barrier.arrive_and_wait();
+                }
+                finished.count_down();
+            });
+        }
+        finished.wait();
+        std::cout << "[main] latch released: all " << workers << " workers finished " << rounds << " rounds" << std::endl;
+        for (auto &t : pool) t.join();
+    }
+
+    // Step 2: barrier episodes per second
+    std::cout << "\nbarrier episodes/sec (hardware threads: " << std::thread::hardware_concurrency() << ")\n"
+              << std::setw(8) << "threads" << std::setw(14) << "SenseBarrier" << std::setw(14) << "TreeBarrier"
+              << std::setw(14) << "std::barrier" << std::setw(15) << "join/recreate" << std::endl;
+    for (std::uint32_t threads : {2u, 4u, 8u, 16u, 32u, 64u}) {
+        const std::uint32_t episodes = 200000 / threads;
+
+        SenseBarrier<> sense(threads);
+        const double s = EpisodesPerSec(threads, episodes, [&](std::uint32_t) { sense.arrive_and_wait(); });
+
+        TreeBarrier<> tree(threads);
+        const double t = EpisodesPerSec(threads, episodes, [&](std::uint32_t id) { tree.arrive_and_wait(id); });
+
+        std::barrier<> standard(threads);
+        const double b = EpisodesPerSec(threads, episodes, [&](std::uint32_t) { standard.arrive_and_wait(); });
+
+        const double j = JoinRecreatePerSec(threads, 20000 / threads);
+
+        std::cout << std::setw(8) << threads << std::fixed << std::setprecision(0)
+                  << std::setw(14) << s << std::setw(14) << t << std::setw(14) << b << std::setw(15) << j << std::endl;
+    }
+
+    return 0;
+}
+
+/* ------------------------------------------------------------------
+THEORY & KEY POINTS: Barriers and latches
+
+1. Phase-parallel work:
+   - N workers each do part of phase k; nobody may start phase k+1 before
+     all of phase k is done.
+   - join() + new threads per phase works but pays thread creation
+     (~10-50 µs per thread) every phase and loses warm caches.
+   - A barrier keeps the workers alive: arrive_and_wait() between phases.
+
+2. Sense-reversing (central) barrier:
+   - Counter of threads still missing + an episode number.
+   - The last arriver resets the counter, THEN bumps the episode (release);
+     waiters wait for the episode to change. Reusable immediately.
+   - Completion step: run by the last arriver while the others wait →
+     single-threaded moment to merge/swap/print (like std::barrier's).
+
+3. Tree (combining) barrier:
+   - A single counter gets N atomic RMWs per episode on ONE cache line.
+   - Tree with fan-in k: each node sees ≤ k arrivals, the winner climbs.
+     Contention O(k) per line, depth log_k(N). Pays off with many cores.
+
+4. Latch: one-shot countdown. count_down() never blocks; wait() until 0.
+   Typical use: "all workers started", "all results ready".
+
+5. Spin-then-park:
+   - Spin (with pause) when the wait is expected to be shorter than a
+     sleep/wake (~µs) AND the awaited threads are running on other cores.
+   - Otherwise park on a futex; the releaser only calls FUTEX_WAKE if
+     somebody is actually asleep.
+   - Oversubscribed (threads > cores): never spin - the spinner steals the
+     CPU from the thread it is waiting for.
+
+------------------------------------------------------------------
+
+💡 Memory Tip / Analogy
+	•	join/recreate = sending the whole team home after each task and hiring a new one.
+	•	Barrier = "everyone meets at the checkpoint before the next leg of the hike".
+	•	Tree barrier = group leaders count their group, then report to the guide.
+	•	Latch = the starting gun: fires once, cannot be reloaded.
+
+*/
@@ -0,0 +1,526 @@
+// 27_Thread_adaptive_wait.cpp
+// clang++ -std=c++17 -O2 -pthread 27_Thread_adaptive_wait.cpp -o a; ./a
+// @author :  DhiraxD
+// @brief  : Spin-then-block waiting for results that are only microseconds away.
+//           result.get() (6_Thread_task_based_concurrency.cpp) and cv.wait
+//           (9_Thread_condition_variable.cpp) always pay a full sleep + wake-up.
+//           - EventCount   : the parking primitive (prepare / commit / cancel wait)
+//           - WaitStrategy : spin with pause → yield → futex park; in Adaptive mode
+//                            the spin budget follows the recent wait durations
+//           - Promise/Future and BlockingQueue built on the two, sharing one strategy
+//           Benchmark: wake-up overhead and CPU for producer delays 100ns .. 1ms. (Linux: futex)
+// References:
+// https://man7.org/linux/man-pages/man2/futex.2.html
+// https://www.1024cores.net/home/lock-free-algorithms/eventcounts
+// https://github.com/facebook/folly/blob/main/folly/synchronization/Baton.h
+// https://www.gnu.org/software/libc/manual/html_node/POSIX-Thread-Mutex.html (PTHREAD_MUTEX_ADAPTIVE_NP)
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <optional>
+#include <string>
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+// -----------------------------------------------------------
+inline void CpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+// Waiter: key = PrepareWait(); if (condition) CancelWait(); else CommitWait(key);
+// Notifier: make the condition true, then NotifyAll().
+// CommitWait() sleeps only if no NotifyAll() happened since PrepareWait(),
+// so a notification between the check and the sleep is never lost.
+class EventCount {
+public:
+    std::uint32_t PrepareWait() {
+        m_Waiters.fetch_add(1);                     // seq_cst: pairs with NotifyAll()
+        return m_Epoch.load();
+    }
+    void CancelWait() { m_Waiters.fetch_sub(1, std::memory_order_relaxed); }
+    void CommitWait(std::uint32_t key) {
+        ::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&m_Epoch), FUTEX_WAIT_PRIVATE, key, nullptr, nullptr, 0);
+        m_Waiters.fetch_sub(1, std::memory_order_relaxed);
+    }
+    void NotifyAll() {
+        m_Epoch.fetch_add(1);
+        if (m_Waiters.load() > 0) {                 // nobody parked → no syscall
+            ::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&m_Epoch), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+        }
+    }
+
+private:
+    std::atomic<std::uint32_t> m_Epoch{0};
+    std::atomic<std::uint32_t> m_Waiters{0};
+};
+
+// -----------------------------------------------------------
+// How to wait for `ready()`:
+//   Park         : go straight to the futex (what std::future / cv do)
+//   SpinThenPark : spin up to maxSpin, yield a few times, then park
+//   Adaptive     : spin budget learned from recent waits:
+//                  - spin succeeded after w      → budget moves towards 2w
+//                  - gave up, result came soon   → budget doubles (too impatient)
+//                  - gave up, result came late   → budget halves (spinning was waste)
+//                  and no spinning at all on a single hardware thread
+// One strategy object can be shared by many futures/queues: they learn together.
+class WaitStrategy {
+public:
+    enum class Mode { Park, SpinThenPark, Adaptive };
+
+    struct Options {
+        Mode mode = Mode::Adaptive;
+        std::chrono::nanoseconds maxSpin = std::chrono::microseconds(20);
+        std::chrono::nanoseconds minSpin = std::chrono::nanoseconds(500);
+        int yields = 2;
+    };
+
+    WaitStrategy() : WaitStrategy(Options()) {}
+    explicit WaitStrategy(Options options)
+        : m_Options(options), m_CanSpin(std::thread::hardware_concurrency() > 1),
+          m_BudgetNs(options.minSpin.count()) {}
+
+    template <typename Ready>
+    void Wait(EventCount &event, Ready ready) {
+        if (ready()) return;
+        const auto start = Clock::now();
+        const std::int64_t budget = SpinBudgetNs();
+        if (budget > 0) {
+            for (std::uint32_t i = 1;; ++i) {
+                if (ready()) return SpinSucceeded(WaitedNs(start));
+                CpuRelax();
+                if ((i & 63) == 0 && WaitedNs(start) > budget) break;  // reading the clock costs ~20ns
+            }
+        }
+        if (m_Options.mode != Mode::Park) {
+            for (int i = 0; i < m_Options.yields; ++i) {
+                if (ready()) return SpinFailed(WaitedNs(start), budget);
+                std::this_thread::yield();
+            }
+        }
+        while (!ready()) {
+            const std::uint32_t key = event.PrepareWait();
+            if (ready()) {
+                event.CancelWait();
+                break;
+            }
+            event.CommitWait(key);
+        }
+        SpinFailed(WaitedNs(start), budget);
+    }
+
+    std::int64_t SpinBudgetNs() const {
+        switch (m_Options.mode) {
+        case Mode::Park:
+            return 0;
+        case Mode::SpinThenPark:
+            return m_Options.maxSpin.count();
+        case Mode::Adaptive:
+        default:
+            return m_CanSpin ? m_BudgetNs.load(std::memory_order_relaxed) : 0;
+        }
+    }
+
+private:
+    static std::int64_t WaitedNs(Clock::time_point start) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+    }
+
+    // Racy read-modify-write on purpose: an approximate budget is enough
+    void SpinSucceeded(std::int64_t waited) {
+        if (m_Options.mode != Mode::Adaptive) return;
+        const std::int64_t target = std::clamp<std::int64_t>(2 * waited, m_Options.minSpin.count(), m_Options.maxSpin.count());
+        const std::int64_t budget = m_BudgetNs.load(std::memory_order_relaxed);
+        m_BudgetNs.store(budget + (target - budget) / 4, std::memory_order_relaxed);
+    }
+
+    void SpinFailed(std::int64_t waited, std::int64_t budget) {
+        if (m_Options.mode != Mode::Adaptive || !m_CanSpin) return;
+        if (waited <= m_Options.maxSpin.count()) {
+            m_BudgetNs.store(std::min<std::int64_t>(m_Options.maxSpin.count(),
+                                                    std::max<std::int64_t>(2 * budget, m_Options.minSpin.count())),
+                             std::memory_order_relaxed);
+        } else {
+            m_BudgetNs.store(budget / 2, std::memory_order_relaxed);
+        }
+    }
+
+    Options m_Options;
+    const bool m_CanSpin;
+    std::atomic<std::int64_t> m_BudgetNs;
+};
+
+// -----------------------------------------------------------
+// One-shot result, like std::promise / std::future
+template <typename T>
+class Future;
+
+template <typename T>
+class Promise {
+    struct State {
+        std::atomic<bool> ready{false};
+        std::optional<T> value;
+        std::exception_ptr error;           // set instead of value: broken promise
+        EventCount event;
+        WaitStrategy *strategy;
+    };
+
+public:
+    explicit Promise(WaitStrategy &strategy) : m_State(std::make_shared<State>()) { m_State->strategy = &strategy; }
+    Promise(Promise&&) noexcept = default;
+    Promise & operator=(Promise &&other) noexcept {
+        Abandon();
+        m_State = std::move(other.m_State);
+        return *this;
+    }
+    // Destroyed without set_value(): get() throws broken_promise instead of waiting forever
+    ~Promise() { Abandon(); }
+
+    Future<T> get_future() {
+        if (!m_State) throw std::future_error(std::future_errc::no_state);
+        return Future<T>(m_State);
+    }
+
+    // Like std::promise: once only, and not on a moved-from promise
+    void set_value(T value) {
+        if (!m_State) throw std::future_error(std::future_errc::no_state);
+        if (m_State->ready.load(std::memory_order_relaxed)) {
+            throw std::future_error(std::future_errc::promise_already_satisfied);
+        }
+        m_State->value = std::move(value);
+        Publish();
+    }
+
+private:
+    void Publish() {
+        m_State->ready.store(true, std::memory_order_release);
+        m_State->event.NotifyAll();
+    }
+    void Abandon() noexcept {
+        if (!m_State || m_State->ready.load(std::memory_order_relaxed)) return;
+        m_State->error = std::make_exception_ptr(std::future_error(std::future_errc::broken_promise));
+        Publish();
+    }
+
+    friend class Future<T>;
+    std::shared_ptr<State> m_State;
+};
+
+template <typename T>
+class Future {
+public:
+    Future() = default;
+
+    // Like std::future: valid once, throws no_state when default-constructed or already consumed
+    T get() {
+        if (!m_State) throw std::future_error(std::future_errc::no_state);
+        const std::shared_ptr<State> state = std::move(m_State);
+        State &s = *state;
+        s.strategy->Wait(s.event, [&s] { return s.ready.load(std::memory_order_acquire); });
+        if (s.error) std::rethrow_exception(s.error);
+        return std::move(*s.value);
+    }
+    bool valid() const noexcept { return m_State != nullptr; }
+
+private:
+    friend class Promise<T>;
+    using State = typename Promise<T>::State;
+    explicit Future(std::shared_ptr<State> state) : m_State(std::move(state)) {}
+    std::shared_ptr<State> m_State;
+};
+
+// Queue whose Pop() waits with the strategy instead of cv.wait
+template <typename T>
+class BlockingQueue {
+public:
+    explicit BlockingQueue(WaitStrategy &strategy) : m_Strategy(strategy) {}
+
+    void Push(T value) {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Items.push_back(std::move(value));
+            m_Size.store(m_Items.size(), std::memory_order_release);
+        }
+        m_NotEmpty.NotifyAll();
+    }
+
+    T Pop() {
+        while (true) {
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                if (!m_Items.empty()) {
+                    T value = std::move(m_Items.front());
+                    m_Items.pop_front();
+                    m_Size.store(m_Items.size(), std::memory_order_relaxed);
+                    return value;
+                }
+            }
+            m_Strategy.Wait(m_NotEmpty, [this] { return m_Size.load(std::memory_order_acquire) > 0; });
+        }
+    }
+
+private:
+    WaitStrategy &m_Strategy;
+    std::mutex m_Mutex;
+    std::deque<T> m_Items;
+    std::atomic<std::size_t> m_Size{0};     // lets waiters check without the mutex
+    EventCount m_NotEmpty;
+};
+
+// -----------------------------------------------------------
+// Channels for the ping-pong benchmark: Send() on one thread, Receive() on another
+class CvChannel {
+public:
+    void Send(int v) {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Data.push_back(v);
+        }
+        m_CV.notify_one();
+    }
+    int Receive() {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_CV.wait(lock, [this] { return !m_Data.empty(); });
+        int v = m_Data.front();
+        m_Data.pop_front();
+        return v;
+    }
+
+private:
+    std::mutex m_Mutex;
+    std::condition_variable m_CV;
+    std::deque<int> m_Data;
+};
+
+class StdFutureChannel {
+public:
+    explicit StdFutureChannel(int rounds) : m_Promises(rounds) {
+        for (auto &p : m_Promises) m_Futures.push_back(p.get_future());
+    }
+    void Send(int v) { m_Promises[m_Sent++].set_value(v); }
+    int Receive() { return m_Futures[m_Received++].get(); }
+
+private:
+    std::vector<std::promise<int>> m_Promises;
+    std::vector<std::future<int>> m_Futures;
+    int m_Sent = 0, m_Received = 0;
+};
+
+class FutureChannel {
+public:
+    FutureChannel(int rounds, WaitStrategy &strategy) {
+        for (int i = 0; i < rounds; ++i) {
+            m_Promises.emplace_back(strategy);
+            m_Futures.push_back(m_Promises.back().get_future());
+        }
+    }
+    void Send(int v) { m_Promises[m_Sent++].set_value(v); }
+    int Receive() { return m_Futures[m_Received++].get(); }
+
+private:
+    std::deque<Promise<int>> m_Promises;
+    std::vector<Future<int>> m_Futures;
+    int m_Sent = 0, m_Received = 0;
+};
+
+class QueueChannel {
+public:
+    explicit QueueChannel(WaitStrategy &strategy) : m_Queue(strategy) {}
+    void Send(int v) { m_Queue.Push(v); }
+    int Receive() { return m_Queue.Pop(); }
+
+private:
+    BlockingQueue<int> m_Queue;
+};
+
+double CpuSeconds() {
+    rusage usage{};
+    ::getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+}
+
+// The "result" takes `delay` of computation
+void Compute(std::chrono::nanoseconds delay) {
+    const auto until = Clock::now() + delay;
+    while (Clock::now() < until) CpuRelax();
+}
+
+struct PingPongResult {
+    double overheadUs;      // round trip minus the delay: 2 hand-offs
+    double cpuPercent;      // CPU used by both threads / wall time
+};
+
+// main sends a request, the producer computes for `delay` and replies
+template <typename Channel>
+PingPongResult PingPong(Channel &request, Channel &reply, int rounds, std::chrono::nanoseconds delay) {
+    std::thread producer([&] {
+        for (int i = 0; i < rounds; ++i) {
+            int v = request.Receive();
+            Compute(delay);
+            reply.Send(v + 1);
+        }
+    });
+    const double cpu0 = CpuSeconds();
+    const auto begin = Clock::now();
+    for (int i = 0; i < rounds; ++i) {
+        request.Send(i);
+        reply.Receive();
+    }
+    const double wall = std::chrono::duration<double>(Clock::now() - begin).count();
+    const double cpu = CpuSeconds() - cpu0;
+    producer.join();
+    const double perRound = wall / rounds * 1e6;
+    return {perRound - std::chrono::duration<double, std::micro>(delay).count(), 100.0 * cpu / wall};
+}
+
+void PrintCell(const PingPongResult &r) {
+    std::cout << std::setw(9) << std::fixed << std::setprecision(1) << r.overheadUs
+              << std::setw(4) << static_cast<int>(r.cpuPercent + 0.5) << "%";
+}
+
+int main() {
+    // Step 1: 6_Thread_task_based_concurrency style, with our Promise/Future
+    {
+        WaitStrategy strategy;
+        Promise<int> promise(strategy);
+        Future<int> result = promise.get_future();
+        std::thread worker([&promise] {
+            Compute(std::chrono::microseconds(5));
+            promise.set_value(10 + 20);
+        });
+        std::cout << "Addition is : " << result.get() << std::endl;
+        worker.join();
+        try {
+            promise.set_value(99);
+        } catch (const std::future_error &e) {
+            std::cout << "[main] second set_value: " << e.what() << std::endl;
+        }
+
+        // a promise dropped without set_value() wakes the waiter with an error
+        Future<int> orphan = Promise<int>(strategy).get_future();
+        try {
+            orphan.get();
+        } catch (const std::future_error &e) {
+            std::cout << "[main] abandoned promise: " << e.what() << std::endl;
+        }
+
+        // 9_Thread_condition_variable style: the queue waits with the same strategy
+        BlockingQueue<std::string> queue(strategy);
+        std::thread downloader([&queue] {
+            for (int i = 0; i < 3; ++i) queue.Push("chunk " + std::to_string(i));
+        });
+        for (int i = 0; i < 3; ++i) std::cout << "[Consumer] " << queue.Pop() << std::endl;
+        downloader.join();
+        std::cout << "[main] learned spin budget: " << strategy.SpinBudgetNs() << " ns" << std::endl;
+    }
+
+    // Step 2: sweep how far away the result is
+    std::cout << "\nhand-off overhead per round trip in us (CPU % of both threads), "
+              << std::thread::hardware_concurrency() << " hardware thread(s)\n"
+              << std::setw(8) << "delay" << std::setw(14) << "cv.wait" << std::setw(14) << "std::future"
+              << std::setw(14) << "park" << std::setw(14) << "spin 20us" << std::setw(14) << "adaptive q"
+              << std::setw(14) << "adaptive fut" << std::endl;
+
+    const std::pair<const char*, std::chrono::nanoseconds> delays[] = {
+        {"100ns", std::chrono::nanoseconds(100)},
+        {"1us", std::chrono::microseconds(1)},
+        {"10us", std::chrono::microseconds(10)},
+        {"100us", std::chrono::microseconds(100)},
+        {"1ms", std::chrono::milliseconds(1)},
+    };
+    for (const auto &d : delays) {
+        // ~100ms per cell
+        const int rounds = static_cast<int>(std::max<std::int64_t>(50, 100000000 / (d.second.count() + 20000)));
+        std::cout << std::setw(8) << d.first;
+        {
+            CvChannel a, b;
+            PrintCell(PingPong(a, b, rounds, d.second));
+        }
+        {
+            StdFutureChannel a(rounds), b(rounds);
+            PrintCell(PingPong(a, b, rounds, d.second));
+        }
+        for (auto mode : {WaitStrategy::Mode::Park, WaitStrategy::Mode::SpinThenPark, WaitStrategy::Mode::Adaptive}) {
+            WaitStrategy::Options options;
+            options.mode = mode;
+            WaitStrategy strategy(options);
+            QueueChannel a(strategy), b(strategy);
+            PrintCell(PingPong(a, b, rounds, d.second));
+        }
+        {
+            WaitStrategy strategy;
+            FutureChannel a(rounds, strategy), b(rounds, strategy);
+            PrintCell(PingPong(a, b, rounds, d.second));
+        }
+        std::cout << std::endl;
+    }
+
+    return 0;
+}
+
+/* ------------------------------------------------------------------
+THEORY & KEY POINTS: Spin-then-block waiting
+
+1. Cost of blocking:
+   - futex sleep + wake = 2 syscalls + a trip through the scheduler;
+     the waiter starts running again several µs after the notify.
+   - If the result was 1µs away, that wake-up dominates the latency.
+
+2. Spinning:
+   - Re-check the condition in a loop with `pause` (x86) / `yield` (ARM):
+     wake-up latency ~ 100ns, but the core is busy while waiting.
+   - Only useful when the producer runs on ANOTHER core. On one core
+     the spinner delays the very thread it waits for.
+
+3. Spin → yield → park:
+   - Spin for a budget (a few µs), then yield, then sleep on a futex.
+   - Bound on waste: at most `budget` of CPU per wait, even when the
+     result is 1ms away (two-competitive: never worse than 2x optimal).
+
+4. Adaptive budget:
+   - Learn from each wait: spinning paid off → budget ≈ 2x that wait;
+     gave up just too early → grow; result was far away → shrink to 0.
+   - With ONE hardware thread never spin: the producer cannot run
+     while we spin (glibc's PTHREAD_MUTEX_ADAPTIVE_NP does the same).
+
+5. EventCount:
+   - Separates "check the condition" from "sleep": PrepareWait() takes a
+     ticket, CommitWait() sleeps only if no NotifyAll() came since.
+   - The notifier pays one atomic increment, and a syscall only if
+     someone actually sleeps → futures, queues and counters can all use it.
+   - A Promise destroyed without set_value() still publishes + notifies
+     (a broken_promise error), otherwise its waiters would sleep forever.
+
+------------------------------------------------------------------
+
+💡 Memory Tip / Analogy
+	•	Park = going home and waiting for the phone call that the coffee is ready.
+	•	Spin = standing at the counter staring at the machine.
+	•	Adaptive = you know this barista: for an espresso you wait at the counter, for a cake order you go sit down.
+
+*/
@@ -0,0 +1,355 @@
+// 28_Thread_combinable.cpp
+// clang++ -std=c++17 -O2 -pthread 28_Thread_combinable.cpp -o a; ./a
+// @author :  DhiraxD
+// @brief  : Combinable<T>: every thread accumulates into its OWN T, the
+//           results are merged once at the end (combine / combine_each / for_each).
+//           5_Thread_mutex.cpp locks g_Mutex 200k times although the result is
+//           just the union of what Download() and Download2() produced.
+//           - lazily created per-thread local, padded to a cache line
+//           - lookup: thread_local array indexed by the instance id (no hashing, no lock);
+//             ids are recycled, so the per-thread table stays as small as the
+//             number of LIVE instances even with one Combinable per request
+//           Benchmark: counters, vectors and histograms vs one mutex-protected object.
+// References:
+// https://www.intel.com/content/www/us/en/docs/onetbb/developer-guide-api-reference/2021-6/combinable.html
+// https://learn.microsoft.com/en-us/cpp/parallel/concrt/reference/combinable-class
+// https://en.cppreference.com/w/cpp/language/storage_duration (thread_local)
+// https://en.wikipedia.org/wiki/False_sharing
+
+#include <iostream>
+#include <iomanip>
+#include <list>
+#include <vector>
+#include <array>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <chrono>
+#include <cstdint>
+
+using Clock = std::chrono::steady_clock;
+
+// -----------------------------------------------------------
+namespace detail {
+// Every live Combinable owns an id; each thread keeps a table id → its local.
+// A destroyed instance returns its id, the next one reuses it → the table is
+// bounded by the number of instances alive at once, not ever created.
+// A reused id gets a new generation: an entry left behind by the previous
+// owner (a dangling Slot*) has the old generation and is never read.
+struct LocalEntry {
+    void *slot = nullptr;
+    std::uint64_t generation = 0;       // 0 = empty
+};
+
+inline std::mutex g_IdMutex;
+inline std::vector<std::size_t> g_FreeIds;
+inline std::size_t g_NextId = 0;
+inline std::atomic<std::uint64_t> g_NextGeneration{1};
+inline thread_local std::vector<LocalEntry> t_Locals;
+
+inline std::size_t AcquireId() {
+    std::lock_guard<std::mutex> lock(g_IdMutex);
+    if (g_FreeIds.empty()) return g_NextId++;
+    const std::size_t id = g_FreeIds.back();
+    g_FreeIds.pop_back();
+    return id;
+}
+
+inline void ReleaseId(std::size_t id) {
+    std::lock_guard<std::mutex> lock(g_IdMutex);
+    g_FreeIds.push_back(id);
+}
+} // namespace detail
+
+template <typename T>
+class Combinable {
+    // alignas(64): two threads' locals never share a cache line (no false sharing)
+    struct alignas(64) Slot {
+        explicit Slot(T v) : value(std::move(v)) {}
+        T value;
+    };
+
+public:
+    Combinable() : Combinable([] { return T(); }) {}
+    explicit Combinable(std::function<T()> init)
+        : m_Id(detail::AcquireId()),
+          m_Generation(detail::g_NextGeneration.fetch_add(1, std::memory_order_relaxed)),
+          m_Init(std::move(init)) {}
+    ~Combinable() { detail::ReleaseId(m_Id); }
+    Combinable(const Combinable&) = delete;
+    Combinable & operator=(const Combinable&) = delete;
+
+    // This thread's T (created on first use). No lock, no atomic on the fast path.
+    T & local() {
+        auto &table = detail::t_Locals;
+        if (m_Id < table.size() && table[m_Id].generation == m_Generation) {
+            return static_cast<Slot*>(table[m_Id].slot)->value;
+        }
+        return CreateLocal();
+    }
+
+    // Merge all locals with op (e.g. std::plus<>()); init() if nobody called local()
+    template <typename BinaryOp>
+    T combine(BinaryOp op) const {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (m_Slots.empty()) return m_Init();
+        T result = m_Slots.front()->value;
+        for (std::size_t i = 1; i < m_Slots.size(); ++i) result = op(std::move(result), m_Slots[i]->value);
+        return result;
+    }
+
+    // fn(const T&) for every local - merge without copying a T per thread
+    template <typename Fn>
+    void combine_each(Fn fn) const {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        for (const auto &slot : m_Slots) fn(slot->value);
+    }
+
+    // fn(T&) for every local - e.g. splice them out
+    template <typename Fn>
+    void for_each(Fn fn) {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        for (auto &slot : m_Slots) fn(slot->value);
+    }
+
+    // Resets every local to init(), keeping the per-thread slots
+    void clear() {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        for (auto &slot : m_Slots) slot->value = m_Init();
+    }
+
+    std::size_t size() const {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_Slots.size();
+    }
+
+private:
+    // Slow path, once per thread: the mutex only guards the list of slots
+    T & CreateLocal() {
+        auto slot = std::make_unique<Slot>(m_Init());
+        Slot *raw = slot.get();
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Slots.push_back(std::move(slot));
+        }
+        auto &table = detail::t_Locals;
+        if (table.size() <= m_Id) table.resize(m_Id + 1);
+        table[m_Id] = {raw, m_Generation};            // overwrites a previous owner's entry
+        return raw->value;
+    }
+
+    const std::size_t m_Id;
+    const std::uint64_t m_Generation;
+    std::function<T()> m_Init;
+    mutable std::mutex m_Mutex;
+    std::vector<std::unique_ptr<Slot>> m_Slots;     // outlive their threads: merge after join()
+};
+
+// -----------------------------------------------------------
+const int SIZE = 100000;
+
+Combinable<std::list<int>> g_Data;
+
+void Download() {
+    auto &data = g_Data.local();            // one lookup, then plain push_back
+    for (int i = 0; i < SIZE; ++i) data.push_back(i);
+}
+
+void Download2() {
+    auto &data = g_Data.local();
+    for (int i = 0; i < SIZE; ++i) data.push_back(i);
+}
+
+// Runs body(threadIndex) on `threads` threads and returns the wall time in ms
+template <typename Body>
+double RunThreads(int threads, Body body) {
+    const auto begin = Clock::now();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) workers.emplace_back(body, t);
+    for (auto &w : workers) w.join();
+    return std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+}
+
+double Ms(Clock::time_point begin) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+}
+
+inline std::uint32_t Bucket(std::uint64_t x) {
+    x *= 0x9E3779B97F4A7C15ULL;             // scatter the values over 256 buckets
+    return static_cast<std::uint32_t>(x >> 56);
+}
+
+void PrintRow(const char *workload, int threads, double mutexMs, double atomicMs, double combinableMs, bool ok) {
+    std::cout << std::left << std::setw(12) << workload << std::right << std::setw(8) << threads
+              << std::fixed << std::setprecision(1)
+              << std::setw(11) << mutexMs;
+    if (atomicMs >= 0) {
+        std::cout << std::setw(11) << atomicMs;
+    } else {
+        std::cout << std::setw(11) << "-";
+    }
+    std::cout << std::setw(13) << combinableMs << std::setw(9) << std::setprecision(1) << mutexMs / combinableMs << "x"
+              << (ok ? "" : "   MISMATCH") << std::endl;
+}
+
+int main() {
+    // Step 1: 5_Thread_mutex.cpp without the mutex
+    std::thread thDownloader(Download);
+    std::thread thDownloader2(Download2);
+    thDownloader.join();
+    thDownloader2.join();
+
+    // Step 2: merge at the end - std::list::splice moves the nodes, O(1) per thread
+    std::list<int> all;
+    g_Data.for_each([&all](std::list<int> &local) { all.splice(all.end(), local); });
+    std::cout << "[main] " << g_Data.size() << " thread locals merged: " << all.size() << " items" << std::endl;
+
+    // one Combinable per "request" on a long-lived thread: ids are recycled,
+    // so this thread's table does not grow with every instance ever created
+    for (int request = 0; request < 10000; ++request) {
+        Combinable<int> perRequest;
+        perRequest.local() += request;
+    }
+    std::cout << "[main] after 10000 per-request Combinables, main's table has "
+              << detail::t_Locals.size() << " entries" << std::endl;
+
+    // Step 3: benchmarks, OPS operations per thread, time includes the merge
+    const int OPS = 1000000;
+    std::cout << "\n" << OPS << " ops per thread, ms (lower is better)\n"
+              << std::left << std::setw(12) << "workload" << std::right << std::setw(8) << "threads"
+              << std::setw(11) << "mutex" << std::setw(11) << "atomic" << std::setw(13) << "Combinable"
+              << std::setw(10) << "speedup" << std::endl;
+
+    for (int threads : {2, 4, 8}) {
+        const std::uint64_t expected = std::uint64_t(threads) * OPS;
+
+        // counter: sum of a per-item value (here: its bucket number)
+        {
+            std::mutex m;
+            std::uint64_t counter = 0;
+            const double mutexMs = RunThreads(threads, [&](int t) {
+                for (int i = 0; i < OPS; ++i) {
+                    const std::uint32_t value = Bucket(std::uint64_t(t) * OPS + i);
+                    std::lock_guard<std::mutex> lock(m);
+                    counter += value;
+                }
+            });
+            std::atomic<std::uint64_t> atomicCounter{0};
+            const double atomicMs = RunThreads(threads, [&](int t) {
+                for (int i = 0; i < OPS; ++i) {
+                    atomicCounter.fetch_add(Bucket(std::uint64_t(t) * OPS + i), std::memory_order_relaxed);
+                }
+            });
+            Combinable<std::uint64_t> counters;
+            auto begin = Clock::now();
+            RunThreads(threads, [&](int t) {
+                auto &local = counters.local();
+                for (int i = 0; i < OPS; ++i) local += Bucket(std::uint64_t(t) * OPS + i);
+            });
+            const std::uint64_t total = counters.combine(std::plus<>());
+            PrintRow("counter", threads, mutexMs, atomicMs, Ms(begin), counter == atomicCounter && total == counter);
+        }
+
+        // vector: everybody appends, result = all items in one vector
+        {
+            std::mutex m;
+            std::vector<int> shared;
+            const double mutexMs = RunThreads(threads, [&](int) {
+                for (int i = 0; i < OPS; ++i) {
+                    std::lock_guard<std::mutex> lock(m);
+                    shared.push_back(i);
+                }
+            });
+            Combinable<std::vector<int>> locals;
+            auto begin = Clock::now();
+            RunThreads(threads, [&](int) {
+                auto &local = locals.local();
+                for (int i = 0; i < OPS; ++i) local.push_back(i);
+            });
+            std::vector<int> merged;
+            std::size_t total = 0;
+            locals.combine_each([&](const std::vector<int> &v) { total += v.size(); });
+            merged.reserve(total);
+            locals.combine_each([&](const std::vector<int> &v) { merged.insert(merged.end(), v.begin(), v.end()); });
+            PrintRow("vector", threads, mutexMs, -1, Ms(begin), shared.size() == expected && merged.size() == expected);
+        }
+
+        // histogram: 256 buckets
+        {
+            using Histogram = std::array<std::uint64_t, 256>;
+            std::mutex m;
+            Histogram shared{};
+            const double mutexMs = RunThreads(threads, [&](int t) {
+                for (int i = 0; i < OPS; ++i) {
+                    const std::uint32_t b = Bucket(std::uint64_t(t) * OPS + i);
+                    std::lock_guard<std::mutex> lock(m);
+                    ++shared[b];
+                }
+            });
+            std::vector<std::atomic<std::uint64_t>> atomicBuckets(256);
+            const double atomicMs = RunThreads(threads, [&](int t) {
+                for (int i = 0; i < OPS; ++i) {
+                    atomicBuckets[Bucket(std::uint64_t(t) * OPS + i)].fetch_add(1, std::memory_order_relaxed);
+                }
+            });
+            Combinable<Histogram> locals([] { return Histogram{}; });
+            auto begin = Clock::now();
+            RunThreads(threads, [&](int t) {
+                auto &local = locals.local();
+                for (int i = 0; i < OPS; ++i) ++local[Bucket(std::uint64_t(t) * OPS + i)];
+            });
+            Histogram merged = locals.combine([](Histogram a, const Histogram &b) {
+                for (std::size_t i = 0; i < a.size(); ++i) a[i] += b[i];
+                return a;
+            });
+            bool ok = true;
+            for (std::size_t i = 0; i < merged.size(); ++i) ok = ok && merged[i] == shared[i] && merged[i] == atomicBuckets[i];
+            PrintRow("histogram", threads, mutexMs, atomicMs, Ms(begin), ok);
+        }
+    }
+
+    return 0;
+}
+
+/* ------------------------------------------------------------------
+THEORY & KEY POINTS: Thread-local accumulation (Combinable)
+
+1. The pattern:
+   - Many threads produce parts of ONE result (sum, list, histogram).
+   - Shared object + mutex: every single update is serialized and the
+     cache line with the data/lock bounces between cores.
+   - But only the FINAL result is needed → accumulate privately, merge once.
+
+2. Combinable<T>:
+   - local(): this thread's T, created lazily with init() on first use.
+   - combine(op): fold all locals (sum, max, union, ...).
+   - combine_each / for_each: visit the locals (merge without copies,
+     e.g. list::splice or vector::insert with reserve).
+   - Locals outlive their threads → merge after join().
+
+3. Making local() cheap:
+   - thread_local table indexed by the instance id: one bounds check, one
+     generation compare and one load - no hashing, no lock, no atomic.
+   - Ids of destroyed instances are reused (free list) → table size =
+     max LIVE instances. The generation tag tells a reused id's new owner
+     from the stale entry of the old one.
+   - The mutex is only taken once per thread (slot creation) and for merging.
+
+4. Padding:
+   - Two threads' locals on the same 64-byte line = false sharing: the
+     line ping-pongs although no data is shared. alignas(64) prevents it.
+
+5. When NOT to use it:
+   - Readers need the running total DURING the computation → atomic counter.
+   - Huge T per thread (memory x threads) or thousands of short threads.
+
+------------------------------------------------------------------
+
+💡 Memory Tip / Analogy
+	•	Mutex = one shared tally sheet, everybody queues to add a mark.
+	•	Combinable = every cashier counts their own drawer; the manager adds them up at closing.
+	•	Padding = giving each cashier their own desk instead of sharing one.
+
+*/
@@ -0,0 +1,470 @@
+// 1_Memory_object_pool.cpp
+// clang++ -std=c++17 -O2 -pthread 1_Memory_object_pool.cpp -o a; ./a
+// @author :  DhiraxD
+// @brief  : Thread-safe object pool for heavy, reusable objects (buffers)
+//           - per-thread free lists (no atomics on the common path)
+//           - lock-free global overflow stack shared by all threads
+//           - RAII handle that gives the object back on destruction
+//           - optional reset hook run before an object is reused
+// References:
+// https://en.cppreference.com/w/cpp/atomic/atomic/compare_exchange
+// https://en.cppreference.com/w/cpp/language/storage_duration (thread_local)
+// https://en.wikipedia.org/wiki/Treiber_stack
+// https://en.wikipedia.org/wiki/ABA_problem
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <list>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <new>
+#include <cstdlib>
+#include <cstdint>
+#include <unordered_set>
+#include <utility>
+#include <string>
+
+// -----------------------------------------------------------
+// Count every heap allocation in the program (for the benchmark)
+std::atomic<long long> g_Allocations{0};
+
+// noinline: once inlined, GCC sees malloc paired with delete / new with free
+// and reports -Wmismatched-new-delete for the standard containers
+[[gnu::noinline]] void * operator new(std::size_t size) {
+    g_Allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+[[gnu::noinline]] void operator delete(void *p) noexcept { std::free(p); }
+[[gnu::noinline]] void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+// -----------------------------------------------------------
+// The heavy object: the String from 2_Thread_pass_arguments.cpp, but now it
+// really owns a buffer, so every construction costs an allocation.
+std::atomic<long long> g_StringConstructed{0};
+
+class String {
+public:
+    String() : m_Buffer(4096) {
+        g_StringConstructed.fetch_add(1, std::memory_order_relaxed);
+    }
+    String(const String &) = delete;
+    String & operator=(const String &) = delete;
+
+    char * data() { return m_Buffer.data(); }
+    std::size_t capacity() const { return m_Buffer.size(); }
+    std::size_t size() const { return m_Size; }
+    void resize(std::size_t n) { m_Size = n; }
+    void clear() { m_Size = 0; }    // keeps the buffer
+
+private:
+    std::vector<char> m_Buffer;
+    std::size_t m_Size = 0;
+};
+
+// -----------------------------------------------------------
+// Registry of live pools: lets a thread that exits give its cached objects
+// back ONLY if the pool still exists (cold path, so a mutex is fine).
+std::mutex g_PoolRegistryMutex;
+std::unordered_set<std::uint64_t> g_LivePools;
+std::atomic<std::uint64_t> g_NextPoolId{1};
+
+// -----------------------------------------------------------
+template <typename T>
+class ObjectPool {
+    static constexpr std::uint32_t CHUNK_SIZE  = 1024;
+    static constexpr std::uint32_t MAX_CHUNKS  = 4096;   // up to 4M objects
+    static constexpr std::size_t   LOCAL_LIMIT = 64;     // per-thread list size before spilling
+
+    // Objects are constructed ONCE (on first use) and live in chunks until
+    // the pool dies. Because slots are never freed, reading slot.next during
+    // a racing pop is always safe; the tag in m_Head protects against ABA.
+    struct alignas(64) Slot {
+        alignas(T) unsigned char storage[sizeof(T)];
+        std::atomic<std::uint32_t> next{0};     // index + 1, 0 == end
+
+        T & object() { return *std::launder(reinterpret_cast<T*>(storage)); }
+    };
+
+    struct LocalCache {
+        std::uint64_t poolId;
+        ObjectPool *pool;
+        std::vector<std::uint32_t> free;        // slot indices
+    };
+
+    struct ThreadCaches {
+        std::vector<LocalCache> caches;
+        ~ThreadCaches() {
+            std::lock_guard<std::mutex> lock(g_PoolRegistryMutex);
+            for (auto &cache : caches) {
+                if (!cache.free.empty() && g_LivePools.count(cache.poolId)) {
+                    cache.pool->PushGlobal(cache.free.data(), cache.free.size());
+                }
+            }
+        }
+    };
+
+public:
+    using ResetHook = std::function<void(T&)>;
+
+    // RAII handle: move-only, returns the object to the pool when destroyed
+    class Handle {
+    public:
+        Handle() = default;
+        Handle(Handle &&other) noexcept
+            : m_Pool(std::exchange(other.m_Pool, nullptr)), m_Index(other.m_Index) {}
+        Handle & operator=(Handle &&other) noexcept {
+            if (this != &other) {
+                reset();
+                m_Pool  = std::exchange(other.m_Pool, nullptr);
+                m_Index = other.m_Index;
+            }
+            return *this;
+        }
+        Handle(const Handle&) = delete;
+        Handle & operator=(const Handle&) = delete;
+        ~Handle() { reset(); }
+
+        T & operator*()  const { return m_Pool->SlotAt(m_Index).object(); }
+        T * operator->() const { return &m_Pool->SlotAt(m_Index).object(); }
+        explicit operator bool() const { return m_Pool != nullptr; }
+
+        void reset() {
+            if (m_Pool) {
+                std::exchange(m_Pool, nullptr)->Release(m_Index);
+            }
+        }
+
+    private:
+        friend class ObjectPool;
+        Handle(ObjectPool *pool, std::uint32_t index) : m_Pool(pool), m_Index(index) {}
+        ObjectPool *m_Pool = nullptr;
+        std::uint32_t m_Index = 0;
+    };
+
+    explicit ObjectPool(ResetHook reset = nullptr)
+        : m_Id(g_NextPoolId.fetch_add(1)), m_Reset(std::move(reset)) {
+        std::lock_guard<std::mutex> lock(g_PoolRegistryMutex);
+        g_LivePools.insert(m_Id);
+    }
+
+    // All handles must have been returned before the pool is destroyed
+    ~ObjectPool() {
+        {
+            std::lock_guard<std::mutex> lock(g_PoolRegistryMutex);
+            g_LivePools.erase(m_Id);
+        }
+        for (std::uint32_t i = 0; i < m_Created.load(); ++i) {
+            SlotAt(i).object().~T();
+        }
+        for (std::uint32_t i = 0; i < m_ChunkCount.load(); ++i) {
+            delete[] m_Chunks[i].load();
+        }
+    }
+
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool & operator=(const ObjectPool&) = delete;
+
+    Handle Acquire() {
+        // 1. own free list - no synchronization at all
+        LocalCache &cache = Local();
+        if (!cache.free.empty()) {
+            std::uint32_t index = cache.free.back();
+            cache.free.pop_back();
+            return Handle(this, index);
+        }
+        // 2. global overflow stack - one CAS
+        std::uint32_t index;
+        if (PopGlobal(index)) {
+            return Handle(this, index);
+        }
+        // 3. grow the pool - the only place a T is constructed
+        return Handle(this, Grow());
+    }
+
+    std::size_t Created() const { return m_Created.load(); }
+
+private:
+    Slot & SlotAt(std::uint32_t index) const {
+        return m_Chunks[index / CHUNK_SIZE].load(std::memory_order_acquire)[index % CHUNK_SIZE];
+    }
+
+    void Release(std::uint32_t index) {
+        if (m_Reset) {
+            m_Reset(SlotAt(index).object());
+        }
+        LocalCache &cache = Local();
+        cache.free.push_back(index);
+        if (cache.free.size() > LOCAL_LIMIT) {
+            // spill the older half so other threads (producers) can reuse it
+            std::size_t half = LOCAL_LIMIT / 2;
+            PushGlobal(cache.free.data(), half);
+            cache.free.erase(cache.free.begin(), cache.free.begin() + half);
+        }
+    }
+
+    LocalCache & Local() {
+        thread_local ThreadCaches tls;
+        thread_local LocalCache *last = nullptr;
+        if (last && last->poolId == m_Id) {
+            return *last;
+        }
+        for (auto &cache : tls.caches) {
+            if (cache.poolId == m_Id) {
+                return *(last = &cache);
+            }
+        }
+        tls.caches.push_back({m_Id, this, {}});
+        tls.caches.back().free.reserve(LOCAL_LIMIT + 1);
+        return *(last = &tls.caches.back());
+    }
+
+    // ---- lock-free Treiber stack with a 32-bit ABA tag ----
+    static std::uint64_t Pack(std::uint32_t tag, std::uint32_t indexPlusOne) {
+        return (std::uint64_t(tag) << 32) | indexPlusOne;
+    }
+
+    // Pushes `count` slots with ONE successful CAS: chain them first, then
+    // swing the head to the first one.
+    void PushGlobal(const std::uint32_t *indices, std::size_t count) {
+        if (count == 0) return;
+        for (std::size_t i = 0; i + 1 < count; ++i) {
+            SlotAt(indices[i]).next.store(indices[i + 1] + 1, std::memory_order_relaxed);
+        }
+        Slot &last = SlotAt(indices[count - 1]);
+        std::uint64_t head = m_Head.load(std::memory_order_relaxed);
+        do {
+            last.next.store(std::uint32_t(head), std::memory_order_relaxed);
+        } while (!m_Head.compare_exchange_weak(head, Pack(std::uint32_t(head >> 32) + 1, indices[0] + 1),
+                                               std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    bool PopGlobal(std::uint32_t &index) {
+        std::uint64_t head = m_Head.load(std::memory_order_acquire);
+        while (std::uint32_t(head) != 0) {
+            std::uint32_t top  = std::uint32_t(head) - 1;
+            std::uint32_t next = SlotAt(top).next.load(std::memory_order_relaxed);
+            if (m_Head.compare_exchange_weak(head, Pack(std::uint32_t(head >> 32) + 1, next),
+                                             std::memory_order_acquire, std::memory_order_acquire)) {
+                index = top;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::uint32_t Grow() {
+        std::lock_guard<std::mutex> lock(m_GrowMutex);
+        std::uint32_t index = m_Created.load(std::memory_order_relaxed);
+        std::uint32_t chunk = index / CHUNK_SIZE;
+        if (chunk >= MAX_CHUNKS) {
+            throw std::bad_alloc();
+        }
+        if (chunk == m_ChunkCount.load(std::memory_order_relaxed)) {
+            m_Chunks[chunk].store(new Slot[CHUNK_SIZE], std::memory_order_release);
+            m_ChunkCount.store(chunk + 1, std::memory_order_release);
+        }
+        ::new (static_cast<void*>(SlotAt(index).storage)) T();
+        m_Created.store(index + 1, std::memory_order_relaxed);
+        return index;
+    }
+
+    const std::uint64_t m_Id;
+    ResetHook m_Reset;
+    alignas(64) std::atomic<std::uint64_t> m_Head{0};
+    alignas(64) std::mutex m_GrowMutex;
+    std::atomic<std::uint32_t> m_Created{0};
+    std::atomic<std::uint32_t> m_ChunkCount{0};
+    std::atomic<Slot*> m_Chunks[MAX_CHUNKS] = {};
+};
+
+// -----------------------------------------------------------
+// Benchmark 1: acquire/release throughput per thread count
+void AcquireReleaseBenchmark() {
+    const int OPS = 200000;
+    std::cout << "\nacquire/release, " << OPS << " ops per thread\n"
+              << std::setw(8) << "threads"
+              << std::setw(16) << "new/delete M/s" << std::setw(14) << "allocs/op"
+              << std::setw(14) << "pool M/s" << std::setw(14) << "allocs/op" << std::endl;
+
+    for (int threads : {1, 2, 4, 8}) {
+        auto Run = [&](auto &&body) {
+            long long before = g_Allocations.load();
+            auto begin = std::chrono::steady_clock::now();
+            std::vector<std::thread> workers;
+            for (int t = 0; t < threads; ++t) workers.emplace_back(body);
+            for (auto &w : workers) w.join();
+            double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+            double total = double(OPS) * threads;
+            std::cout << std::setw(14) << std::fixed << std::setprecision(2) << total / secs / 1e6
+                      << std::setw(14) << std::setprecision(3) << (g_Allocations.load() - before) / total;
+        };
+
+        std::cout << std::setw(8) << threads << "  ";
+        Run([&] {
+            for (int i = 0; i < OPS; ++i) {
+                auto s = std::make_unique<String>();
+                s->data()[0] = char(i);
+            }
+        });
+
+        ObjectPool<String> pool([](String &s) { s.clear(); });
+        Run([&] {
+            for (int i = 0; i < OPS; ++i) {
+                auto s = pool.Acquire();
+                s->data()[0] = char(i);
+            }
+        });
+        std::cout << std::endl;
+    }
+}
+
+// -----------------------------------------------------------
+// Benchmark 2: producer/consumer buffer recycling
+// Download() fills a 4KB buffer and hands it to ProcessData() through the
+// condition_variable queue of 10_Thread_ConditionVariable_example.cpp.
+// The consumer drops the buffer; with the pool it flows back to the producer.
+template <typename Buffer, typename Make>
+void RecyclingBenchmark(const std::string &name, Make make) {
+    const int MESSAGES = 200000;
+    std::list<Buffer> queue;
+    std::mutex mtx;
+    std::condition_variable cv;
+    bool finished = false;
+    long long checksum = 0;
+
+    long long before = g_Allocations.load();
+    long long constructedBefore = g_StringConstructed.load();
+    auto begin = std::chrono::steady_clock::now();
+
+    std::thread producer([&] {
+        for (int i = 0; i < MESSAGES; ++i) {
+            Buffer buf = make();
+            buf->resize(buf->capacity());
+            buf->data()[0] = char(i);
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                queue.push_back(std::move(buf));
+            }
+            cv.notify_one();
+        }
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            finished = true;
+        }
+        cv.notify_one();
+    });
+
+    std::thread consumer([&] {
+        std::list<Buffer> batch;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mtx);
+                cv.wait(lock, [&] { return !queue.empty() || finished; });
+                if (queue.empty()) break;
+                batch.splice(batch.end(), queue);
+            }
+            for (auto &buf : batch) checksum += buf->data()[0] + static_cast<long long>(buf->size());
+            batch.clear();      // buffers go back to the pool here
+        }
+    });
+
+    producer.join();
+    consumer.join();
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    std::cout << std::left << std::setw(22) << name << std::right
+              << std::setw(12) << std::fixed << std::setprecision(2) << MESSAGES / secs / 1e6
+              << std::setw(14) << std::setprecision(3) << double(g_Allocations.load() - before) / MESSAGES
+              << std::setw(16) << (g_StringConstructed.load() - constructedBefore)
+              << "   (checksum " << checksum << ")" << std::endl;
+}
+
+// -----------------------------------------------------------
+int main() {
+    // Step 1: handles give the object back; the reset hook runs on return
+    {
+        ObjectPool<String> pool([](String &s) { s.clear(); });
+        {
+            auto file = pool.Acquire();
+            file->resize(100);
+            std::cout << "[main] first acquire, size = " << file->size() << std::endl;
+        }   // returned to the pool here
+        auto again = pool.Acquire();
+        std::cout << "[main] second acquire reuses it, size = " << again->size()
+                  << ", objects created = " << pool.Created() << std::endl;
+    }
+
+    AcquireReleaseBenchmark();
+
+    std::cout << "\nproducer/consumer, 200000 x 4KB buffers\n"
+              << std::left << std::setw(22) << "buffers" << std::right
+              << std::setw(12) << "Mmsg/s" << std::setw(14) << "allocs/msg"
+              << std::setw(16) << "String()s" << std::endl;
+    RecyclingBenchmark<std::unique_ptr<String>>("new String per msg",
+        [] { return std::make_unique<String>(); });
+    ObjectPool<String> pool([](String &s) { s.clear(); });
+    RecyclingBenchmark<ObjectPool<String>::Handle>("ObjectPool<String>",
+        [&] { return pool.Acquire(); });
+
+    return 0;
+}
+
+/* ------------------------------------------------------------------
+THEORY & KEY POINTS: Object pools
+
+1. Why pool?
+   - Some objects are expensive to create: they own buffers (malloc),
+     file handles, sockets, big tables.
+   - If they are created and destroyed at a high rate, most of the cost is
+     construction/destruction, not the actual work.
+   - A pool keeps finished objects and hands them out again.
+
+2. Per-thread free lists:
+   - Each thread keeps its own small list of free objects.
+   - Acquire/release on that list needs NO atomics and touches only
+     thread-private memory → as fast as a vector push/pop.
+
+3. Global overflow stack:
+   - Producer/consumer pipelines move objects ACROSS threads: the consumer's
+     list keeps growing, the producer's is always empty.
+   - When a local list grows past a limit, half of it is spilled to a shared
+     lock-free (Treiber) stack, from which empty threads refill.
+   - A batch is chained first and published with ONE CAS.
+
+4. ABA problem:
+   - Thread A reads head=X, next=Y; gets preempted.
+   - Others pop X, pop Y, push X again → head is X again, but Y is gone.
+   - A's CAS(X → Y) would succeed and corrupt the stack.
+   - Fix used here: head = (tag, index); every successful CAS bumps the tag.
+   - Slots are never freed while the pool lives, so reading slot.next of a
+     slot somebody else popped is harmless.
+
+5. RAII handle:
+   - Handle is move-only (like unique_ptr) and returns the object in its
+     destructor → no leaks, exception safe, works across threads.
+
+6. Reset hook:
+   - A returned object may hold stale state (old size, old file name).
+   - The hook (e.g. clear()) resets the VISIBLE state but keeps capacity,
+     which is exactly the thing we wanted to keep.
+
+7. Costs / caveats:
+   - Memory is never given back to the OS until the pool is destroyed.
+   - Objects stay in the cache of a thread; at thread exit they return to
+     the global stack.
+
+------------------------------------------------------------------
+
+💡 Memory Tip / Analogy
+	•	new/delete = buying a new mug for every coffee and throwing it away.
+	•	Object pool = a rack of mugs; wash (reset hook) and reuse.
+	•	Per-thread list = each barista keeps a few mugs at their station; the shared rack is only for refills.
+
+*/
@@ -0,0 +1,474 @@
+// 2_Memory_compressed_int_column.cpp
+// clang++ -std=c++17 -O2 2_Memory_compressed_int_column.cpp -o a; ./a
+// @author :  DhiraxD
+// @brief  : Compressed, append-only integer column for the 5M sequential ints
+//           Download() pushes into a std::list in 1_Thread_creation.cpp
+//           - blocks of 128 ints: delta + zigzag + bit-packing (SIMD-BP128 style)
+//           - SSE2 decoder (4 lanes at once) with a scalar fallback
+//           - block index for random access, streaming iterator for scans
+//           Compared with std::vector<int> and std::list<int>.
+// References:
+// https://arxiv.org/abs/1209.2137 (Lemire & Boytsov, "Decoding billions of integers per second through vectorization")
+// https://github.com/lemire/FastPFor
+// https://developers.google.com/protocol-buffers/docs/encoding#signed-ints (zigzag)
+// https://www.intel.com/content/www/us/en/docs/intrinsics-guide/index.html
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <list>
+#include <array>
+#include <chrono>
+#include <random>
+#include <atomic>
+#include <new>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <algorithm>
+#include <utility>
+#include <malloc.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// -----------------------------------------------------------
+// Count heap bytes in use (malloc_usable_size + chunk header), so the list's
+// per-node overhead shows up, not just sizeof(node)
+std::atomic<long long> g_HeapBytes{0};
+
+// noinline: see 1_Memory_object_pool.cpp
+[[gnu::noinline]] void * operator new(std::size_t size) {
+    if (void *p = std::malloc(size ? size : 1)) {
+        g_HeapBytes.fetch_add(malloc_usable_size(p) + sizeof(std::size_t), std::memory_order_relaxed);
+        return p;
+    }
+    throw std::bad_alloc();
+}
+[[gnu::noinline]] void operator delete(void *p) noexcept {
+    if (p) g_HeapBytes.fetch_sub(malloc_usable_size(p) + sizeof(std::size_t), std::memory_order_relaxed);
+    std::free(p);
+}
+[[gnu::noinline]] void operator delete(void *p, std::size_t) noexcept { operator delete(p); }
+
+// -----------------------------------------------------------
+// Block layout (BLOCK = 128 values, "vertical" / 4-lane interleaved):
+//   value i lives in lane i % 4, row i / 4   (32 rows x 4 lanes)
+//   delta[i] = v[i] - v[i-4]  (v[-4..-1] = block base)  → one SIMD add per row
+//   zigzag(delta) maps small negative deltas to small unsigned numbers
+//   each lane's 32 zigzagged deltas are bit-packed with `width` bits into
+//   `width` 32-bit words; the 4 lanes' words are interleaved → `width` x 128 bits
+const int BLOCK = 128;
+const int LANES = 4;
+const int ROWS = BLOCK / LANES;
+
+inline std::uint32_t ZigZag(std::uint32_t delta) {
+    return (delta << 1) ^ (0u - (delta >> 31));
+}
+inline std::uint32_t UnZigZag(std::uint32_t z) {
+    return (z >> 1) ^ (0u - (z & 1));
+}
+
+inline int BitWidth(std::uint32_t v) {
+    return v == 0 ? 0 : 32 - __builtin_clz(v);
+}
+
+// packs 128 zigzagged deltas into width*4 words
+void PackBlock(const std::uint32_t *z, int width, std::uint32_t *out) {
+    std::memset(out, 0, sizeof(std::uint32_t) * LANES * width);
+    for (int lane = 0; lane < LANES; ++lane) {
+        for (int row = 0; row < ROWS; ++row) {
+            const std::uint64_t bit = std::uint64_t(row) * width;
+            const std::uint64_t word = bit / 32, shift = bit % 32;
+            const std::uint32_t v = z[row * LANES + lane];
+            out[word * LANES + lane] |= v << shift;
+            if (shift + width > 32) {
+                out[(word + 1) * LANES + lane] |= v >> (32 - shift);
+            }
+        }
+    }
+}
+
+// Scalar reference decoder: one value at a time
+void DecodeBlockScalar(const std::uint32_t *in, int width, std::int32_t base, std::int32_t *out) {
+    const std::uint32_t mask = width == 32 ? ~0u : (1u << width) - 1;
+    std::uint32_t prev[LANES] = {std::uint32_t(base), std::uint32_t(base), std::uint32_t(base), std::uint32_t(base)};
+    for (int row = 0; row < ROWS; ++row) {
+        const std::uint64_t bit = std::uint64_t(row) * width;
+        const std::uint64_t word = bit / 32, shift = bit % 32;
+        for (int lane = 0; lane < LANES; ++lane) {
+            std::uint32_t v = 0;
+            if (width != 0) {
+                v = in[word * LANES + lane] >> shift;
+                if (shift + width > 32) v |= in[(word + 1) * LANES + lane] << (32 - shift);
+                v &= mask;
+            }
+            prev[lane] += UnZigZag(v);
+            out[row * LANES + lane] = static_cast<std::int32_t>(prev[lane]);
+        }
+    }
+}
+
+// Single value: walk one lane from row 0 to the value's row
+std::int32_t DecodeValue(const std::uint32_t *in, int width, std::int32_t base, int index) {
+    const int lane = index % LANES, lastRow = index / LANES;
+    std::uint32_t value = std::uint32_t(base);
+    if (width == 0) return base;
+    const std::uint32_t mask = width == 32 ? ~0u : (1u << width) - 1;
+    for (int row = 0; row <= lastRow; ++row) {
+        const int bit = row * width, word = bit / 32, shift = bit % 32;
+        std::uint32_t v = in[word * LANES + lane] >> shift;
+        if (shift + width > 32) v |= in[(word + 1) * LANES + lane] << (32 - shift);
+        value += UnZigZag(v & mask);
+    }
+    return static_cast<std::int32_t>(value);
+}
+
+#if defined(__SSE2__)
+// SIMD decoder: one row (4 values) per step. WIDTH is a template parameter so
+// the shifts/loads of the fully unrolled loop are compile-time constants -
+// the same trick FastPFor uses with its 33 generated unpack routines.
+template <int WIDTH>
+void DecodeBlockSse(const std::uint32_t *in, std::int32_t base, std::int32_t *out) {
+    const __m128i *src = reinterpret_cast<const __m128i*>(in);
+    const __m128i one = _mm_set1_epi32(1);
+    const __m128i mask = _mm_set1_epi32(WIDTH == 32 ? -1 : int((1u << WIDTH) - 1));
+    __m128i prev = _mm_set1_epi32(base);
+    __m128i cur = WIDTH ? _mm_loadu_si128(src) : _mm_setzero_si128();
+    int word = 0, shift = 0;
+#pragma GCC unroll 32
+    for (int row = 0; row < ROWS; ++row) {
+        __m128i v;
+        if (WIDTH == 0) {
+            v = _mm_setzero_si128();
+        } else if (shift + WIDTH <= 32) {
+            v = _mm_and_si128(_mm_srli_epi32(cur, shift), mask);
+            shift += WIDTH;
+            if (shift == 32 && row + 1 < ROWS) {
+                cur = _mm_loadu_si128(src + ++word);
+                shift = 0;
+            }
+        } else {
+            __m128i lo = _mm_srli_epi32(cur, shift);
+            cur = _mm_loadu_si128(src + ++word);
+            __m128i hi = _mm_slli_epi32(cur, 32 - shift);
+            v = _mm_and_si128(_mm_or_si128(lo, hi), mask);
+            shift += WIDTH - 32;
+        }
+        // un-zigzag: (v >> 1) ^ -(v & 1), then the running sum per lane
+        __m128i delta = _mm_xor_si128(_mm_srli_epi32(v, 1),
+                                      _mm_sub_epi32(_mm_setzero_si128(), _mm_and_si128(v, one)));
+        prev = _mm_add_epi32(prev, delta);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out) + row, prev);
+    }
+}
+
+using DecodeFn = void (*)(const std::uint32_t*, std::int32_t, std::int32_t*);
+
+template <std::size_t... W>
+constexpr std::array<DecodeFn, sizeof...(W)> MakeDecoders(std::index_sequence<W...>) {
+    return {{&DecodeBlockSse<int(W)>...}};
+}
+constexpr auto g_Decoders = MakeDecoders(std::make_index_sequence<33>{});
+#endif
+
+void DecodeBlock(const std::uint32_t *in, int width, std::int32_t base, std::int32_t *out) {
+#if defined(__SSE2__)
+    g_Decoders[width](in, base, out);
+#else
+    DecodeBlockScalar(in, width, base, out);
+#endif
+}
+
+// -----------------------------------------------------------
+class CompressedIntColumn {
+public:
+    struct BlockInfo {
+        std::uint32_t offset;      // first word in m_Words
+        std::int32_t base;         // value before the block's first delta
+        std::uint8_t width;        // bits per zigzagged delta (0..32)
+    };
+
+    void push_back(std::int32_t value) {
+        m_Tail[m_TailSize++] = value;
+        if (m_TailSize == BLOCK) {
+            EncodeTail();
+        }
+    }
+
+    std::size_t size() const { return m_Blocks.size() * BLOCK + m_TailSize; }
+    std::size_t blocks() const { return m_Blocks.size(); }
+    int width(std::size_t block) const { return m_Blocks[block].width; }
+
+    // Random access: find the block through the index, then sum only the
+    // deltas of value i's lane up to its row (at most 32, not all 128)
+    std::int32_t operator[](std::size_t i) const {
+        const std::size_t block = i / BLOCK;
+        if (block == m_Blocks.size()) return m_Tail[i % BLOCK];
+        const BlockInfo &info = m_Blocks[block];
+        return DecodeValue(m_Words.data() + info.offset, info.width, info.base, int(i % BLOCK));
+    }
+
+    // Decodes block `block` into out[0..127]
+    void DecodeBlockAt(std::size_t block, std::int32_t *out) const {
+        const BlockInfo &info = m_Blocks[block];
+        DecodeBlock(m_Words.data() + info.offset, info.width, info.base, out);
+    }
+    void DecodeBlockAtScalar(std::size_t block, std::int32_t *out) const {
+        const BlockInfo &info = m_Blocks[block];
+        DecodeBlockScalar(m_Words.data() + info.offset, info.width, info.base, out);
+    }
+
+    // Calls fn(const int32_t *values, size_t count) for every block + the tail
+    template <typename Fn>
+    void ForEachBlock(Fn &&fn) const {
+        alignas(16) std::int32_t values[BLOCK];
+        for (std::size_t b = 0; b < m_Blocks.size(); ++b) {
+            DecodeBlockAt(b, values);
+            fn(values, std::size_t(BLOCK));
+        }
+        if (m_TailSize) fn(m_Tail.data(), m_TailSize);
+    }
+
+    // Memory the column really owns
+    std::size_t bytes() const {
+        return m_Words.capacity() * sizeof(std::uint32_t) + m_Blocks.capacity() * sizeof(BlockInfo)
+             + sizeof(*this);
+    }
+    void shrink_to_fit() {
+        m_Words.shrink_to_fit();
+        m_Blocks.shrink_to_fit();
+    }
+
+    // Streaming forward iterator: decodes one block at a time into its buffer
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::int32_t;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const std::int32_t*;
+        using reference = const std::int32_t&;
+
+        const_iterator(const CompressedIntColumn *column, std::size_t index) : m_Column(column), m_Index(index) {
+            if (m_Index < m_Column->size()) Load();
+        }
+        reference operator*() const { return m_Current[m_Index % BLOCK]; }
+        const_iterator & operator++() {
+            if (++m_Index % BLOCK == 0 && m_Index < m_Column->size()) Load();
+            return *this;
+        }
+        const_iterator operator++(int) { const_iterator tmp = *this; ++*this; return tmp; }
+        bool operator==(const const_iterator &other) const { return m_Index == other.m_Index; }
+        bool operator!=(const const_iterator &other) const { return m_Index != other.m_Index; }
+
+    private:
+        void Load() {
+            const std::size_t block = m_Index / BLOCK;
+            if (block == m_Column->m_Blocks.size()) {
+                m_Current = m_Column->m_Tail.data();
+            } else {
+                m_Column->DecodeBlockAt(block, m_Buffer);
+                m_Current = m_Buffer;
+            }
+        }
+
+        const CompressedIntColumn *m_Column;
+        std::size_t m_Index;
+        const std::int32_t *m_Current = nullptr;
+        alignas(16) std::int32_t m_Buffer[BLOCK];
+    };
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, size()); }
+
+private:
+    void EncodeTail() {
+        const std::int32_t base = m_Tail[0];
+        std::uint32_t z[BLOCK];
+        std::uint32_t all = 0;
+        for (int i = 0; i < BLOCK; ++i) {
+            const std::uint32_t prev = std::uint32_t(i < LANES ? base : m_Tail[i - LANES]);
+            z[i] = ZigZag(std::uint32_t(m_Tail[i]) - prev);     // wraps, never UB
+            all |= z[i];
+        }
+        const int width = BitWidth(all);
+        const std::size_t offset = m_Words.size();
+        m_Words.resize(offset + std::size_t(width) * LANES);
+        PackBlock(z, width, m_Words.data() + offset);
+        m_Blocks.push_back({static_cast<std::uint32_t>(offset), base, static_cast<std::uint8_t>(width)});
+        m_TailSize = 0;
+    }
+
+    std::vector<std::uint32_t> m_Words;
+    std::vector<BlockInfo> m_Blocks;
+    std::array<std::int32_t, BLOCK> m_Tail{};
+    std::size_t m_TailSize = 0;
+};
+
+// -----------------------------------------------------------
+const int SIZE = 5000000;
+
+double Seconds(std::chrono::steady_clock::time_point begin) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+}
+
+// Best of a few runs - scans are short and noisy
+template <typename Fn>
+double BestSeconds(Fn &&fn, int runs = 5) {
+    double best = 1e9;
+    for (int r = 0; r < runs; ++r) {
+        auto begin = std::chrono::steady_clock::now();
+        fn();
+        best = std::min(best, Seconds(begin));
+    }
+    return best;
+}
+
+void Compare(const char *name, const std::vector<std::int32_t> &input) {
+    const double gb = double(input.size()) * sizeof(std::int32_t) / 1e9;
+    long long sink = 0;
+
+    // std::list<int>: 1_Thread_creation.cpp's g_Data
+    long long heapBefore = g_HeapBytes.load();
+    std::list<std::int32_t> list(input.begin(), input.end());
+    const double listBytes = double(g_HeapBytes.load() - heapBefore);
+    const double listScan = BestSeconds([&] { for (int v : list) sink += v; });
+
+    heapBefore = g_HeapBytes.load();
+    std::vector<std::int32_t> vec(input.begin(), input.end());
+    const double vecBytes = double(g_HeapBytes.load() - heapBefore);
+    const double vecScan = BestSeconds([&] { for (int v : vec) sink += v; });
+
+    CompressedIntColumn column;
+    auto begin = std::chrono::steady_clock::now();
+    for (std::int32_t v : input) column.push_back(v);
+    const double encode = Seconds(begin);
+    column.shrink_to_fit();
+    const double colBytes = double(column.bytes());
+
+    std::vector<std::int32_t> out(input.size());
+    const double decodeSimd = BestSeconds([&] {
+        for (std::size_t b = 0; b < column.blocks(); ++b) column.DecodeBlockAt(b, out.data() + b * BLOCK);
+    });
+    const double decodeScalar = BestSeconds([&] {
+        for (std::size_t b = 0; b < column.blocks(); ++b) column.DecodeBlockAtScalar(b, out.data() + b * BLOCK);
+    });
+    const double iterScan = BestSeconds([&] { for (int v : column) sink += v; });
+    const double blockScan = BestSeconds([&] {
+        column.ForEachBlock([&](const std::int32_t *p, std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i) sink += p[i];
+        });
+    });
+
+    // correctness: every value back, in order
+    std::size_t i = 0;
+    bool ok = column.size() == input.size();
+    for (int v : column) ok = ok && v == input[i++];
+
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<std::size_t> pick(0, input.size() - 1);
+    const int LOOKUPS = 1000000;
+    std::vector<std::size_t> idx(LOOKUPS);
+    for (auto &x : idx) x = pick(rng);
+    const double colRandom = BestSeconds([&] { for (auto x : idx) sink += column[x]; }, 1);
+    const double vecRandom = BestSeconds([&] { for (auto x : idx) sink += vec[x]; }, 1);
+    for (auto x : idx) ok = ok && column[x] == input[x];
+
+    std::cout << "\n" << name << " (" << input.size() << " ints)" << (ok ? "" : "   MISMATCH!") << "\n"
+              << std::fixed << std::setprecision(2)
+              << "  bytes/element : list " << listBytes / input.size()
+              << ", vector " << vecBytes / input.size()
+              << ", column " << colBytes / input.size() << "\n"
+              << "  column encode : " << gb / encode << " GB/s"
+              << ", decode SSE2 " << gb / decodeSimd << " GB/s"
+              << ", decode scalar " << gb / decodeScalar << " GB/s\n"
+              << "  scan (Gint/s) : list " << input.size() / listScan / 1e9
+              << ", vector " << input.size() / vecScan / 1e9
+              << ", column iterator " << input.size() / iterScan / 1e9
+              << ", column ForEachBlock " << input.size() / blockScan / 1e9 << "\n"
+              << "  random access : vector " << vecRandom / LOOKUPS * 1e9 << " ns"
+              << ", column " << colRandom / LOOKUPS * 1e9 << " ns"
+              << (sink == 42 ? " " : "") << std::endl;
+}
+
+int main() {
+    // Step 1: small example, look at the block index
+    {
+        CompressedIntColumn column;
+        for (int i = 0; i < 300; ++i) column.push_back(1000 + i);
+        std::cout << "[main] 300 sequential ints → " << column.blocks() << " blocks + "
+                  << column.size() - column.blocks() * BLOCK << " in the tail, block 0 uses "
+                  << column.width(0) << " bits/value, column[257] = " << column[257] << std::endl;
+    }
+
+    // Step 2: the 5M sequential ints of Download()
+    std::vector<std::int32_t> input(SIZE);
+    for (int i = 0; i < SIZE; ++i) input[i] = i;
+    Compare("sequential 0..N", input);
+
+    // Step 3: "mostly monotone ids": gaps 0..63, sometimes a slightly older id
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> gap(0, 63), jitter(0, 99);
+    std::int32_t id = 1000000;
+    for (int i = 0; i < SIZE; ++i) {
+        id += gap(rng);
+        input[i] = jitter(rng) == 0 ? id - gap(rng) : id;
+    }
+    Compare("monotone ids with jitter", input);
+
+    // Step 4: worst case, random values → no compression, still correct
+    for (auto &v : input) v = static_cast<std::int32_t>(rng());
+    Compare("random 32-bit", input);
+
+    return 0;
+}
+
+/* ------------------------------------------------------------------
+THEORY & KEY POINTS: Compressed integer columns
+
+1. Why std::list<int> is so big:
+   - Each node = prev + next pointers + the int → 24 bytes, and malloc
+     rounds it to a 32-byte chunk. 5M ints ≈ 160MB for 20MB of data.
+   - Nodes are scattered → every step of a scan is a cache miss.
+
+2. Delta encoding:
+   - Sorted / monotone ids: neighbours are close → store the differences.
+   - Sequential 0,1,2,... → every delta is the same small number.
+
+3. Zigzag:
+   - Deltas can be negative (out-of-order ids).
+   - zigzag: 0,-1,1,-2,2 → 0,1,2,3,4 (small magnitude = few bits).
+
+4. Bit-packing per block:
+   - For each block of 128 deltas take the widest one → `width` bits each.
+   - 128 values x width bits instead of 128 x 32 bits.
+   - A few large deltas only hurt their own block (FastPFor goes further and
+     stores such "exceptions" separately).
+
+5. SIMD decoding (SIMD-BP128 style):
+   - Values are interleaved over 4 lanes: value i → lane i % 4.
+   - Deltas are taken against the value 4 positions back, so the prefix
+     sum is ONE vector add per 4 values instead of a serial chain.
+   - One decoder per width (templates), fully unrolled → constant shifts.
+
+6. Block index:
+   - Per block: offset of its words, base value and width.
+   - column[i] = index lookup + sum of one lane's deltas up to row i/4
+     (≤ 32 steps) → O(1), ~tens of ns.
+   - Sequential scans should use the iterator / ForEachBlock, which decode
+     each block ONCE.
+
+7. Trade-offs:
+   - Append-only: changing a value in the middle means re-encoding a block.
+   - Random data (no small deltas) does not compress → width 32 + index.
+
+------------------------------------------------------------------
+
+💡 Memory Tip / Analogy
+	•	std::list = every number in its own envelope, each envelope with two addresses written on it.
+	•	Delta + bit-packing = writing "+1, +1, +1 ..." in tiny handwriting on one page.
+	•	Block index = the table of contents: jump to the right page, then read that page only.
+
+*/
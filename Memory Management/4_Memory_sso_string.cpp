@@ -0,0 +1,513 @@
+// 4_Memory_sso_string.cpp
+// clang++ -std=c++17 -O2 -pthread 4_Memory_sso_string.cpp -o a; ./a
+// @author :  DhiraxD
+// @brief  : A real String for file names and paths, replacing the empty demo String
+//           of 2_Thread_pass_arguments.cpp (no data, copy-only).
+//           - 24-byte object, up to 23 chars stored inline (small string optimization)
+//           - move = copy 24 bytes, never allocates, noexcept
+//           - compile-time literals: "index.html"_lit → String points at the
+//             literal, no allocation, no copy
+//           - optional arena: BasicString<std::pmr::polymorphic_allocator<char>>
+//           Benchmark: pass-by-value into a call / std::thread / std::async, and
+//           container churn (vector, sort, copy, unordered_set) vs std::string.
+// References:
+// https://github.com/facebook/folly/blob/main/folly/FBString.h
+// https://joellaity.com/2020/01/31/string.html (libc++ string layout)
+// https://en.cppreference.com/w/cpp/language/user_literal
+// https://en.cppreference.com/w/cpp/memory/polymorphic_allocator
+// https://en.cppreference.com/w/cpp/memory/uses_allocator
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <algorithm>
+#include <thread>
+#include <future>
+#include <chrono>
+#include <atomic>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+using Clock = std::chrono::steady_clock;
+
+// -----------------------------------------------------------
+// Count every heap allocation in the program (for the benchmark)
+std::atomic<long long> g_Allocations{0};
+
+// noinline: see 1_Memory_object_pool.cpp
+[[gnu::noinline]] void * operator new(std::size_t size) {
+    g_Allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+[[gnu::noinline]] void operator delete(void *p) noexcept { std::free(p); }
+[[gnu::noinline]] void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+// -----------------------------------------------------------
+// A string literal known at compile time. Only "..."_lit can make one, so the
+// characters always have static storage and a terminating '\0'.
+class StringLiteral {
+public:
+    constexpr const char * data() const { return m_Data; }
+    constexpr std::size_t size() const { return m_Size; }
+
+private:
+    constexpr StringLiteral(const char *data, std::size_t size) : m_Data(data), m_Size(size) {}
+    friend constexpr StringLiteral operator""_lit(const char *text, std::size_t size);
+
+    const char *m_Data;
+    std::size_t m_Size;
+};
+
+constexpr StringLiteral operator""_lit(const char *text, std::size_t size) { return StringLiteral(text, size); }
+
+// -----------------------------------------------------------
+// Layout: 24 raw bytes, the LAST byte tells the representation.
+//   inline : chars[0..22], byte 23 = 23 - size  (size 23 → byte 23 is the '\0')
+//   heap   : { char *data; size_t size; uint64 capacity | HEAP << 56 }
+//   literal: { const char *data; size_t size; LITERAL << 56 }  - not owned
+// Byte 23 is the top byte of the third word → little-endian only.
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "String layout assumes little-endian");
+
+template <typename Alloc = std::allocator<char>>
+class BasicString : private Alloc {     // private base: an empty allocator takes no space
+    using Traits = std::allocator_traits<Alloc>;
+    static_assert(std::is_same_v<typename Traits::value_type, char>, "BasicString: Alloc::value_type must be char");
+
+    static constexpr std::size_t INLINE_CAPACITY = 23;
+    static constexpr unsigned char CATEGORY_MASK = 0xC0;
+    static constexpr unsigned char LITERAL = 0x40;
+    static constexpr unsigned char HEAP = 0x80;
+    static constexpr std::uint64_t CAPACITY_MASK = (std::uint64_t(1) << 56) - 1;
+
+    struct Large {
+        char *data;
+        std::size_t size;
+        std::uint64_t capacityAndCategory;
+    };
+    static_assert(sizeof(Large) == 24, "BasicString: expected a 64-bit target");
+
+public:
+    using allocator_type = Alloc;
+    using size_type = std::size_t;
+
+    BasicString() noexcept(noexcept(Alloc())) : BasicString(Alloc()) {}
+    explicit BasicString(const Alloc &alloc) noexcept : Alloc(alloc) { SetInlineSize(0); }
+
+    BasicString(std::string_view text, const Alloc &alloc = Alloc()) : Alloc(alloc) { InitCopy(text); }
+    BasicString(const char *text, const Alloc &alloc = Alloc()) : BasicString(std::string_view(text), alloc) {}
+    BasicString(const std::string &text, const Alloc &alloc = Alloc()) : BasicString(std::string_view(text), alloc) {}
+
+    // Compile-time literal: points at the literal's static storage, O(1), no allocation
+    BasicString(StringLiteral literal, const Alloc &alloc = Alloc()) noexcept : Alloc(alloc) {
+        StoreLarge({const_cast<char*>(literal.data()), literal.size(), std::uint64_t(LITERAL) << 56});
+    }
+
+    BasicString(const BasicString &other) : BasicString(other, Traits::select_on_container_copy_construction(other.GetAlloc())) {}
+    BasicString(const BasicString &other, const Alloc &alloc) : Alloc(alloc) {
+        if (other.Category() == HEAP) {
+            InitCopy(other.view());     // ≤ 23 chars lands inline again
+        } else {
+            std::memcpy(m_Bytes, other.m_Bytes, sizeof(m_Bytes));     // inline or literal: 24 bytes
+        }
+    }
+
+    // Move: take the 24 bytes, leave other empty. Never allocates.
+    BasicString(BasicString &&other) noexcept : Alloc(std::move(other.GetAlloc())) { Steal(other); }
+    BasicString(BasicString &&other, const Alloc &alloc) : Alloc(alloc) {
+        if (other.Category() != HEAP || GetAlloc() == other.GetAlloc()) {
+            Steal(other);
+        } else {
+            InitCopy(other.view());     // buffer belongs to another arena: copy it
+        }
+    }
+
+    ~BasicString() { Release(); }
+
+    BasicString & operator=(const BasicString &other) {
+        if (this == &other) return *this;
+        if (Category() != HEAP && other.Category() != HEAP) {
+            std::memcpy(m_Bytes, other.m_Bytes, sizeof(m_Bytes));     // inline or literal: 24 bytes
+            return *this;
+        }
+        assign(other.view());
+        return *this;
+    }
+
+    BasicString & operator=(BasicString &&other) noexcept(Traits::propagate_on_container_move_assignment::value ||
+                                                           Traits::is_always_equal::value) {
+        if (this == &other) return *this;
+        if (Traits::propagate_on_container_move_assignment::value || GetAlloc() == other.GetAlloc() ||
+            other.Category() != HEAP) {
+            Release();
+            if constexpr (Traits::propagate_on_container_move_assignment::value) GetAlloc() = std::move(other.GetAlloc());
+            Steal(other);
+        } else {
+            assign(other.view());
+        }
+        return *this;
+    }
+
+    // Reuses the current heap buffer when it is big enough
+    BasicString & assign(std::string_view text) {
+        if (Category() == HEAP && text.size() <= Capacity()) {
+            Large large = LoadLarge();
+            std::memmove(large.data, text.data(), text.size());     // text may point into *this
+            large.data[text.size()] = '\0';
+            large.size = text.size();
+            StoreLarge(large);
+            return *this;
+        }
+        BasicString fresh(text, GetAlloc());
+        Release();
+        Steal(fresh);
+        return *this;
+    }
+
+    BasicString & append(std::string_view text) {
+        const size_type oldSize = size();
+        const size_type newSize = oldSize + text.size();
+        if (Category() == LITERAL || newSize > capacity()) {
+            // build the result in fresh storage first: text may point into *this
+            BasicString fresh(GetAlloc());
+            fresh.reserve(std::max(newSize, Category() == LITERAL ? newSize : 2 * capacity()));
+            fresh.AppendFits(view());
+            fresh.AppendFits(text);
+            Release();
+            Steal(fresh);
+            return *this;
+        }
+        AppendFits(text);
+        return *this;
+    }
+    BasicString & operator+=(std::string_view text) { return append(text); }
+    void push_back(char c) { append(std::string_view(&c, 1)); }
+
+    void reserve(size_type newCapacity) {
+        newCapacity = std::max(newCapacity, size());    // a literal's capacity() is 0: never shrink below size()
+        if (Category() != LITERAL && newCapacity <= capacity()) return;
+        if (newCapacity <= INLINE_CAPACITY) {       // literal → inline copy
+            BasicString fresh(view(), GetAlloc());
+            Release();
+            Steal(fresh);
+            return;
+        }
+        if (newCapacity > CAPACITY_MASK - 1) throw std::length_error("String::reserve: too large");
+        char *buffer = Traits::allocate(GetAlloc(), newCapacity + 1);
+        const std::string_view old = view();
+        std::memcpy(buffer, old.data(), old.size());
+        buffer[old.size()] = '\0';
+        Release();
+        StoreLarge({buffer, old.size(), newCapacity | (std::uint64_t(HEAP) << 56)});
+    }
+
+    void clear() noexcept {
+        if (Category() == HEAP) {
+            Large large = LoadLarge();
+            large.size = 0;
+            large.data[0] = '\0';
+            StoreLarge(large);
+        } else {
+            SetInlineSize(0);
+        }
+    }
+
+    const char * data() const noexcept { return Category() == 0 ? InlineChars() : LoadLarge().data; }
+    const char * c_str() const noexcept { return data(); }
+    size_type size() const noexcept { return Category() == 0 ? INLINE_CAPACITY - m_Bytes[23] : LoadLarge().size; }
+    size_type capacity() const noexcept {
+        switch (Category()) {
+        case 0: return INLINE_CAPACITY;
+        case HEAP: return Capacity();
+        default: return size();      // literal: read-only, the first write copies it
+        }
+    }
+    bool empty() const noexcept { return size() == 0; }
+    char operator[](size_type i) const noexcept { return data()[i]; }
+    std::string_view view() const noexcept { return std::string_view(data(), size()); }
+    operator std::string_view() const noexcept { return view(); }
+    allocator_type get_allocator() const { return GetAlloc(); }
+
+    bool is_inline() const noexcept { return Category() == 0; }
+    bool is_literal() const noexcept { return Category() == LITERAL; }
+
+    friend bool operator==(const BasicString &a, const BasicString &b) noexcept { return a.view() == b.view(); }
+    friend bool operator!=(const BasicString &a, const BasicString &b) noexcept { return a.view() != b.view(); }
+    friend bool operator<(const BasicString &a, const BasicString &b) noexcept { return a.view() < b.view(); }
+    friend std::ostream & operator<<(std::ostream &out, const BasicString &s) { return out << s.view(); }
+
+private:
+    Alloc & GetAlloc() noexcept { return *this; }
+    const Alloc & GetAlloc() const noexcept { return *this; }
+
+    unsigned char Category() const noexcept { return m_Bytes[23] & CATEGORY_MASK; }
+    size_type Capacity() const noexcept { return LoadLarge().capacityAndCategory & CAPACITY_MASK; }
+    char * InlineChars() noexcept { return reinterpret_cast<char*>(m_Bytes); }
+    const char * InlineChars() const noexcept { return reinterpret_cast<const char*>(m_Bytes); }
+
+    Large LoadLarge() const noexcept {
+        Large large;
+        std::memcpy(&large, m_Bytes, sizeof(large));
+        return large;
+    }
+    void StoreLarge(const Large &large) noexcept { std::memcpy(m_Bytes, &large, sizeof(large)); }
+
+    void SetInlineSize(size_type size) noexcept {
+        InlineChars()[size] = '\0';
+        m_Bytes[23] = static_cast<unsigned char>(INLINE_CAPACITY - size);
+    }
+
+    void InitCopy(std::string_view text) {
+        if (text.size() <= INLINE_CAPACITY) {
+            std::memcpy(m_Bytes, text.data(), text.size());
+            SetInlineSize(text.size());
+            return;
+        }
+        SetInlineSize(0);       // valid state in case allocate() throws
+        if (text.size() > CAPACITY_MASK - 1) throw std::length_error("String: too large");
+        char *buffer = Traits::allocate(GetAlloc(), text.size() + 1);
+        std::memcpy(buffer, text.data(), text.size());
+        buffer[text.size()] = '\0';
+        StoreLarge({buffer, text.size(), text.size() | (std::uint64_t(HEAP) << 56)});
+    }
+
+    // Caller checked: owned storage with room for text
+    void AppendFits(std::string_view text) noexcept {
+        const size_type oldSize = size();
+        if (Category() == 0) {
+            std::memmove(InlineChars() + oldSize, text.data(), text.size());
+            SetInlineSize(oldSize + text.size());
+        } else {
+            Large large = LoadLarge();
+            std::memmove(large.data + oldSize, text.data(), text.size());
+            large.size = oldSize + text.size();
+            large.data[large.size] = '\0';
+            StoreLarge(large);
+        }
+    }
+
+    void Steal(BasicString &other) noexcept {
+        std::memcpy(m_Bytes, other.m_Bytes, sizeof(m_Bytes));
+        other.SetInlineSize(0);
+    }
+
+    void Release() noexcept {
+        if (Category() == HEAP) {
+            const Large large = LoadLarge();
+            Traits::deallocate(GetAlloc(), large.data, (large.capacityAndCategory & CAPACITY_MASK) + 1);
+        }
+        SetInlineSize(0);
+    }
+
+    alignas(8) unsigned char m_Bytes[24];
+};
+
+using String = BasicString<>;
+using ArenaString = BasicString<std::pmr::polymorphic_allocator<char>>;
+
+template <typename Alloc>
+struct std::hash<BasicString<Alloc>> {
+    std::size_t operator()(const BasicString<Alloc> &s) const noexcept { return std::hash<std::string_view>()(s.view()); }
+};
+
+// -----------------------------------------------------------
+// 2_Thread_pass_arguments.cpp's Download, now taking the file name BY VALUE
+std::atomic<std::size_t> g_Sink{0};
+
+template <typename S>
+void Download(S fileName) {
+    g_Sink.fetch_add(fileName.size(), std::memory_order_relaxed);
+}
+
+struct Cost {
+    double ns;
+    double allocations;
+};
+
+template <typename Fn>
+Cost PerCall(int calls, Fn fn) {
+    fn();       // warm-up
+    const long long before = g_Allocations.load();
+    const auto begin = Clock::now();
+    for (int i = 0; i < calls; ++i) fn();
+    const double ns = std::chrono::duration<double, std::nano>(Clock::now() - begin).count();
+    return {ns / calls, double(g_Allocations.load() - before) / calls};
+}
+
+template <typename S>
+void PassByValueRow(const char *what, const S &name, int calls, std::ostream &out) {
+    const Cost call = PerCall(calls * 100, [&name] { Download<S>(name); });
+    const Cost thread = PerCall(calls, [&name] { std::thread(Download<S>, name).join(); });
+    const Cost async = PerCall(calls, [&name] { std::async(std::launch::async, Download<S>, name).get(); });
+    out << std::setw(26) << what << std::fixed
+        << std::setw(10) << std::setprecision(1) << call.ns << std::setw(6) << std::setprecision(0) << call.allocations
+        << std::setw(10) << std::setprecision(0) << thread.ns << std::setw(6) << thread.allocations
+        << std::setw(10) << async.ns << std::setw(6) << async.allocations << std::endl;
+}
+
+// Churn: build a vector of names, sort it, copy it, put it in a hash set, drop everything
+template <typename Vector, typename Set>
+std::size_t ChurnRound(const std::vector<std::string> &source, Vector names, Set unique) {
+    names.reserve(source.size());
+    for (const std::string &s : source) names.emplace_back(std::string_view(s));
+    std::sort(names.begin(), names.end());
+    Vector copy(names, names.get_allocator());
+    for (auto &name : copy) unique.insert(std::move(name));
+    return unique.size() + names.size();
+}
+
+template <typename Fn>
+Cost PerName(std::size_t names, int rounds, Fn round) {
+    const long long before = g_Allocations.load();
+    const auto begin = Clock::now();
+    std::size_t check = 0;
+    for (int r = 0; r < rounds; ++r) check += round();
+    const double ns = std::chrono::duration<double, std::nano>(Clock::now() - begin).count();
+    g_Sink.fetch_add(check, std::memory_order_relaxed);
+    return {ns / (double(names) * rounds), double(g_Allocations.load() - before) / (double(names) * rounds)};
+}
+
+int main() {
+    // Step 1: the three representations
+    constexpr StringLiteral kIndex = "index.html"_lit;
+    static_assert(kIndex.size() == 10, "computed at compile time");
+
+    String large("/var/lib/downloads/user_000123/report.json");   // 42 chars: heap
+    long long before = g_Allocations.load();
+    String small("report-2024-10-17.json");                       // 22 chars: inline
+    String literal = kIndex;                                      // points at the literal
+    String literalCopy = literal;                                 // still no allocation
+    std::cout << "[main] sizeof(String) = " << sizeof(String) << ", sizeof(std::string) = " << sizeof(std::string)
+              << ", sizeof(ArenaString) = " << sizeof(ArenaString) << std::endl;
+    std::cout << "[main] " << small << " inline: " << small.is_inline() << "; " << literalCopy
+              << " literal: " << literalCopy.is_literal() << "; allocations: " << g_Allocations.load() - before << std::endl;
+
+    // Step 2: moves never allocate and never copy characters
+    before = g_Allocations.load();
+    String moved = std::move(large);
+    std::cout << "[main] moved '" << moved << "' with " << g_Allocations.load() - before
+              << " allocations, source now '" << large << "'" << std::endl;
+
+    // Step 3: writing to a literal copies it first (copy-on-write, once)
+    literalCopy += ".gz";
+    std::cout << "[main] " << literalCopy << " literal: " << literalCopy.is_literal()
+              << ", original still '" << literal << "'" << std::endl;
+    String longLiteral("/var/lib/downloads/user_000123/report.json"_lit);
+    longLiteral.reserve(30);                                       // below size(): copies all 42 chars
+    std::cout << "[main] reserve(30) on a 42-char literal: '" << longLiteral << "', capacity " << longLiteral.capacity()
+              << ", literal: " << longLiteral.is_literal() << std::endl;
+
+    // Step 4: arena strings - long names come from a buffer, not the heap
+    alignas(std::max_align_t) unsigned char arenaBuffer[4096];
+    std::pmr::monotonic_buffer_resource arena(arenaBuffer, sizeof(arenaBuffer), std::pmr::null_memory_resource());
+    std::vector<std::string> downloads;
+    for (int i = 0; i < 10; ++i) downloads.push_back("/var/lib/downloads/user_" + std::to_string(i) + "/report.json");
+    before = g_Allocations.load();
+    std::pmr::vector<ArenaString> paths(&arena);
+    for (const std::string &path : downloads) paths.emplace_back(path);
+    std::cout << "[main] " << paths.size() << " arena paths, heap allocations: " << g_Allocations.load() - before << std::endl;
+
+    // Step 5: pass by value into a call / std::thread / std::async
+    const int LAUNCHES = 2000;
+    const std::string stdShort = "file_0001.txt", stdMedium = "report-2024-10-17.json",
+                      stdLong = "/var/lib/downloads/user_000123/report.json";
+    std::cout << "\nDownload(S fileName): ns (allocations) per call\n"
+              << std::setw(26) << "argument" << std::setw(16) << "direct call" << std::setw(16) << "std::thread"
+              << std::setw(16) << "std::async" << std::endl;
+    PassByValueRow("std::string 13 chars", stdShort, LAUNCHES, std::cout);
+    PassByValueRow("String      13 chars", String(stdShort), LAUNCHES, std::cout);
+    PassByValueRow("std::string 22 chars", stdMedium, LAUNCHES, std::cout);
+    PassByValueRow("String      22 chars", String(stdMedium), LAUNCHES, std::cout);
+    PassByValueRow("std::string 42 chars", stdLong, LAUNCHES, std::cout);
+    PassByValueRow("String      42 chars", String(stdLong), LAUNCHES, std::cout);
+    PassByValueRow("String      42 literal", String("/var/lib/downloads/user_000123/report.json"_lit), LAUNCHES, std::cout);
+
+    // Step 6: container churn; names are 1/3 short, 1/3 16..23 chars, 1/3 long paths
+    std::vector<std::string> source;
+    for (int i = 0; i < 30000; ++i) {
+        const std::string id = std::to_string(i * 7919 % 100000);
+        switch (i % 3) {
+        case 0: source.push_back("f_" + id + ".txt"); break;
+        case 1: source.push_back("report-" + id + "-2024.json"); break;
+        default: source.push_back("/var/lib/downloads/user_" + id + "/report.json"); break;
+        }
+    }
+    const int ROUNDS = 20;
+    const Cost stdCost = PerName(source.size(), ROUNDS, [&source] {
+        return ChurnRound(source, std::vector<std::string>(), std::unordered_set<std::string>());
+    });
+    const Cost ssoCost = PerName(source.size(), ROUNDS, [&source] {
+        return ChurnRound(source, std::vector<String>(), std::unordered_set<String>());
+    });
+    std::pmr::unsynchronized_pool_resource pool;
+    const Cost arenaCost = PerName(source.size(), ROUNDS, [&source, &pool] {
+        std::pmr::monotonic_buffer_resource roundArena(&pool);     // everything freed at once
+        return ChurnRound(source, std::pmr::vector<ArenaString>(&roundArena),
+                                       std::pmr::unordered_set<ArenaString>(&roundArena));
+    });
+    std::cout << "\ncontainer churn (vector + sort + copy + unordered_set), per name\n" << std::fixed
+              << std::setw(14) << "std::string" << std::setw(8) << std::setprecision(1) << stdCost.ns << " ns"
+              << std::setw(8) << std::setprecision(2) << stdCost.allocations << " allocations\n"
+              << std::setw(14) << "String" << std::setw(8) << std::setprecision(1) << ssoCost.ns << " ns"
+              << std::setw(8) << std::setprecision(2) << ssoCost.allocations << " allocations\n"
+              << std::setw(14) << "ArenaString" << std::setw(8) << std::setprecision(1) << arenaCost.ns << " ns"
+              << std::setw(8) << std::setprecision(2) << arenaCost.allocations << " allocations" << std::endl;
+
+    return 0;
+}
+
+/* ------------------------------------------------------------------
+THEORY & KEY POINTS: SSO string
+
+1. The demo String of 2_Thread_pass_arguments.cpp:
+   - Holds nothing and has no move constructor → std::thread(Download, file)
+     always copies. A real string copy = malloc + memcpy (+ free later).
+
+2. Small string optimization (SSO):
+   - The object is 24 bytes anyway (pointer, size, capacity) → reuse those
+     bytes to store short strings directly: 23 chars + 1 tag byte.
+   - Tag byte = 23 - size, so a full 23-char string ends in a 0 byte, which
+     is also its '\0' terminator (the fbstring trick).
+   - libstdc++ std::string: 32 bytes, 15 chars inline. libc++: 24 bytes, 22 chars.
+
+3. Cheap move:
+   - Whatever the representation, move = memcpy 24 bytes + reset the source.
+     noexcept → std::vector moves (not copies) on growth.
+
+4. Compile-time literals:
+   - "index.html"_lit is a constexpr StringLiteral (pointer + size).
+   - A String made from it just points at the literal: no allocation, copies
+     are 24-byte copies too. The first write copies it into owned storage.
+
+5. Arena allocation:
+   - BasicString<std::pmr::polymorphic_allocator<char>>: long strings come
+     from a memory_resource (monotonic arena → freeing is a no-op, the whole
+     arena is dropped at once). Costs 8 more bytes per string.
+   - uses-allocator construction: a pmr::vector<ArenaString> passes its arena
+     to every element automatically.
+
+6. Passing to threads:
+   - std::thread / std::async decay-copy the argument into the thread state:
+     SSO makes that copy allocation-free for names ≤ 23 chars.
+   - Still cheaper: std::move(name) into the thread, or std::cref() when the
+     caller outlives the thread (see 2_Thread_pass_arguments.cpp).
+
+------------------------------------------------------------------
+
+💡 Memory Tip / Analogy
+	•	Heap string = a luggage tag with the address of a warehouse holding the item.
+	•	SSO = the item is small enough to clip onto the tag itself.
+	•	Literal = a tag pointing at a museum exhibit: look, don't touch; copy it before you write on it.
+	•	Arena = a rented storage room: clear out the whole room at once instead of item by item.
+
+*/
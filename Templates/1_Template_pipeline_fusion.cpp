@@ -0,0 +1,445 @@
+// 1_Template_pipeline_fusion.cpp
+// clang++ -std=c++17 -O2 -pthread 1_Template_pipeline_fusion.cpp -o a; ./a
+// @author :  DhiraxD
+// @brief  : A pipeline DSL where every stage is a TYPE:
+//               Pipe() | Map(f) | Filter(p) | Hop<1024>() | Map(g) ...
+//           - adjacent Map/Filter stages are fused at compile time into ONE
+//             loop body: no queues, no std::function, no virtual calls
+//           - only an explicit Hop<N>() becomes a thread boundary, connected
+//             by a typed single-producer/single-consumer ring buffer
+//           - the type flowing between stages is computed at compile time;
+//             a stage that cannot take it is a static_assert, not a runtime error
+//           The Download → ProcessData flow of 10_Thread_ConditionVariable_example.cpp
+//           without globals, and a fused vs unfused 5-stage benchmark.
+// References:
+// https://en.cppreference.com/w/cpp/language/parameter_pack
+// https://en.cppreference.com/w/cpp/language/if (constexpr if)
+// https://en.cppreference.com/w/cpp/types/result_of (std::invoke_result)
+// https://en.cppreference.com/w/cpp/language/fold
+// https://www.boost.org/doc/libs/release/libs/hana/doc/html/index.html
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <array>
+#include <string>
+#include <tuple>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <functional>
+#include <chrono>
+#include <type_traits>
+#include <utility>
+#include <cstdint>
+
+using Clock = std::chrono::steady_clock;
+
+// -----------------------------------------------------------
+// Stages: plain aggregates holding the user's callable. Their TYPE is what
+// the pipeline works with.
+template <typename F>
+struct MapStage {
+    F fn;
+};
+
+template <typename P>
+struct FilterStage {
+    P pred;
+};
+
+template <std::size_t Capacity>
+struct HopStage {};
+
+template <typename F>
+MapStage<F> Map(F fn) { return {std::move(fn)}; }
+
+template <typename P>
+FilterStage<P> Filter(P pred) { return {std::move(pred)}; }
+
+template <std::size_t Capacity = 1024>
+HopStage<Capacity> Hop() { return {}; }
+
+template <typename T>
+struct IsHop : std::false_type {};
+
+template <std::size_t Capacity>
+struct IsHop<HopStage<Capacity>> : std::true_type {};
+
+template <typename T>
+struct IsFilter : std::false_type {};
+
+template <typename P>
+struct IsFilter<FilterStage<P>> : std::true_type {};
+
+// -----------------------------------------------------------
+// Type computation: what comes OUT of Stage when In goes in
+template <typename In, typename Stage>
+struct StageOutput {
+    static_assert(sizeof(Stage) == 0, "not a pipeline stage: use Map(), Filter() or Hop<N>()");
+};
+
+template <typename In, typename F>
+struct StageOutput<In, MapStage<F>> {
+    static_assert(std::is_invocable_v<F&, const In&>, "Map(): the function cannot take the previous stage's output type");
+    using type = std::decay_t<std::invoke_result_t<F&, const In&>>;
+    static_assert(!std::is_void_v<type>, "Map(): the function must return a value");
+};
+
+template <typename In, typename P>
+struct StageOutput<In, FilterStage<P>> {
+    static_assert(std::is_invocable_r_v<bool, P&, const In&>,
+                  "Filter(): the predicate must take the previous stage's output type and return bool");
+    using type = In;
+};
+
+template <typename In, std::size_t Capacity>
+struct StageOutput<In, HopStage<Capacity>> {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Hop<N>(): N must be a power of two");
+    static_assert(std::is_default_constructible_v<In> && std::is_move_assignable_v<In>,
+                  "Hop<N>(): the type crossing threads must be default-constructible and movable");
+    using type = In;
+};
+
+// Output of a whole stage list, left to right
+template <typename In, typename... Stages>
+struct PipelineOutput {
+    using type = In;
+};
+
+template <typename In, typename First, typename... Rest>
+struct PipelineOutput<In, First, Rest...> {
+    using type = typename PipelineOutput<typename StageOutput<In, First>::type, Rest...>::type;
+};
+
+// -----------------------------------------------------------
+// Bounded single-producer / single-consumer ring: the only thing a Hop costs.
+// Each side caches the other side's index and touches it only when the
+// cached value says full/empty.
+template <typename T, std::size_t Capacity>
+class SpscRing {
+public:
+    void Push(T value) {
+        const std::size_t tail = m_Tail.load(std::memory_order_relaxed);
+        while (tail - m_CachedHead == Capacity) {
+            m_CachedHead = m_Head.load(std::memory_order_acquire);
+            if (tail - m_CachedHead == Capacity) std::this_thread::yield();
+        }
+        m_Items[tail & (Capacity - 1)] = std::move(value);
+        m_Tail.store(tail + 1, std::memory_order_release);
+    }
+
+    // false once Close()d and drained
+    bool Pop(T &out) {
+        const std::size_t head = m_Head.load(std::memory_order_relaxed);
+        while (head == m_CachedTail) {
+            m_CachedTail = m_Tail.load(std::memory_order_acquire);
+            if (head != m_CachedTail) break;
+            if (m_Closed.load(std::memory_order_acquire)) {
+                m_CachedTail = m_Tail.load(std::memory_order_acquire);     // items pushed before Close()
+                if (head == m_CachedTail) return false;
+                break;
+            }
+            std::this_thread::yield();
+        }
+        out = std::move(m_Items[head & (Capacity - 1)]);
+        m_Head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    void Close() { m_Closed.store(true, std::memory_order_release); }
+
+private:
+    alignas(64) std::atomic<std::size_t> m_Head{0};     // consumer
+    std::size_t m_CachedTail = 0;
+    alignas(64) std::atomic<std::size_t> m_Tail{0};     // producer
+    std::size_t m_CachedHead = 0;
+    alignas(64) std::atomic<bool> m_Closed{false};
+    std::array<T, Capacity> m_Items{};
+};
+
+// Threads and rings of one Run(). Hops are created downstream-first, so they
+// are closed in reverse: close ring k, join its thread (which has pushed
+// everything into ring k+1), then ring k+1, ...
+class Runtime {
+    struct Link {
+        std::function<void()> close;
+        std::thread consumer;
+    };
+
+public:
+    Runtime() = default;
+    Runtime(const Runtime&) = delete;
+    Runtime & operator=(const Runtime&) = delete;
+    ~Runtime() { Finish(); }
+
+    void Add(std::function<void()> close, std::thread consumer) {
+        m_Links.push_back({std::move(close), std::move(consumer)});
+    }
+
+    void Finish() {
+        for (auto it = m_Links.rbegin(); it != m_Links.rend(); ++it) {
+            it->close();
+            if (it->consumer.joinable()) it->consumer.join();
+        }
+        m_Links.clear();
+    }
+
+private:
+    std::vector<Link> m_Links;
+};
+
+// -----------------------------------------------------------
+template <typename... Stages>
+class Pipeline {
+public:
+    Pipeline() = default;
+    explicit Pipeline(std::tuple<Stages...> stages) : m_Stages(std::move(stages)) {}
+
+    // Appending a stage creates a NEW type: Pipeline<Stages..., Stage>
+    template <typename Stage>
+    Pipeline<Stages..., Stage> operator|(Stage stage) const {
+        return Pipeline<Stages..., Stage>(std::tuple_cat(m_Stages, std::make_tuple(std::move(stage))));
+    }
+
+    static constexpr std::size_t Threads = 1 + (std::size_t(IsHop<Stages>::value) + ... + 0);
+
+    // Output type for a given input type
+    template <typename In>
+    using Output = typename PipelineOutput<In, Stages...>::type;
+
+    // source.ForEach(emit) pushes every item; sink(const Output&) runs on the last thread
+    template <typename Source, typename Sink>
+    void Run(const Source &source, Sink sink) const {
+        using In = typename Source::value_type;
+        static_assert(std::is_invocable_v<Sink&, const Output<In>&>, "Run(): the sink cannot take the pipeline's output type");
+        Runtime runtime;
+        auto head = Build<0, In>(runtime, std::move(sink));
+        source.ForEach(head);
+        runtime.Finish();
+    }
+
+private:
+    // Returns the callable that feeds item type In into stage I and everything
+    // after it. Map/Filter wrap the next callable in a lambda → after inlining
+    // the whole segment is one loop body.
+    template <std::size_t I, typename In, typename Sink>
+    auto Build(Runtime &runtime, Sink sink) const {
+        if constexpr (I == sizeof...(Stages)) {
+            return [sink](const In &x) mutable { sink(x); };
+        } else {
+            using Stage = std::tuple_element_t<I, std::tuple<Stages...>>;
+            using Out = typename StageOutput<In, Stage>::type;
+            const Stage &stage = std::get<I>(m_Stages);
+            auto next = Build<I + 1, Out>(runtime, std::move(sink));
+
+            if constexpr (IsHop<Stage>::value) {
+                return BuildHop<In>(runtime, std::move(next), stage);
+            } else if constexpr (IsFilter<Stage>::value) {
+                return [pred = stage.pred, next](const In &x) mutable {
+                    if (pred(x)) next(x);
+                };
+            } else {
+                return [fn = stage.fn, next](const In &x) mutable { next(fn(x)); };
+            }
+        }
+    }
+
+    template <typename In, typename Next, std::size_t Capacity>
+    static auto BuildHop(Runtime &runtime, Next next, const HopStage<Capacity> &) {
+        auto ring = std::make_shared<SpscRing<In, Capacity>>();
+        std::thread consumer([ring, next]() mutable {
+            In x;
+            while (ring->Pop(x)) next(x);
+        });
+        runtime.Add([ring] { ring->Close(); }, std::move(consumer));
+        return [ring](const In &x) { ring->Push(x); };
+    }
+
+    std::tuple<Stages...> m_Stages;
+};
+
+inline Pipeline<> Pipe() { return {}; }
+
+// -----------------------------------------------------------
+// Sources
+template <typename T>
+struct Range {
+    using value_type = T;
+    T first, last;
+
+    template <typename Emit>
+    void ForEach(Emit &emit) const {
+        for (T i = first; i < last; ++i) emit(i);
+    }
+};
+
+template <typename Container>
+struct From {
+    using value_type = typename Container::value_type;
+    const Container &items;
+
+    template <typename Emit>
+    void ForEach(Emit &emit) const {
+        for (const auto &x : items) emit(x);
+    }
+};
+
+template <typename Container>
+From(const Container &) -> From<Container>;
+
+// -----------------------------------------------------------
+// The 5-stage map/filter workload of the benchmark
+inline std::uint64_t Hash(std::uint64_t x) { return x * 0x9E3779B97F4A7C15ULL; }
+inline bool KeepA(std::uint64_t x) { return (x >> 60) != 0; }
+inline std::uint64_t Mix(std::uint64_t x) { return x ^ (x >> 29); }
+inline bool KeepB(std::uint64_t x) { return x % 3 != 0; }
+inline std::uint64_t Low(std::uint64_t x) { return x & 0xFFFF; }
+
+double Seconds(Clock::time_point begin) {
+    return std::chrono::duration<double>(Clock::now() - begin).count();
+}
+
+void PrintRow(const char *name, std::size_t threads, std::uint64_t items, double seconds, std::uint64_t sum, std::uint64_t expected) {
+    std::cout << std::left << std::setw(40) << name << std::right << std::setw(8) << threads
+              << std::setw(12) << std::fixed << std::setprecision(1) << items / seconds / 1e6
+              << std::setw(10) << std::setprecision(1) << seconds * 1e3
+              << (sum == expected ? "" : "   MISMATCH") << std::endl;
+}
+
+int main() {
+    // Step 1: Download → ProcessData as types. One hop: downloading and
+    // processing overlap on two threads; no g_Data, g_Mutex, g_CV.
+    {
+        auto flow = Pipe()
+            | Map([](int i) { return std::string((i + 1) * 1000, char('a' + i)); }) // Download chunk i
+            | Filter([](const std::string &s) { return s.front() != 'd'; })        // drop the corrupt chunk 3
+            | Hop<64>()                                                           // ---- thread boundary ----
+            | Map([](const std::string &s) { return s.size(); });                 // ProcessData
+        static_assert(std::is_same_v<decltype(flow)::Output<int>, std::size_t>, "types are known at compile time");
+
+        std::size_t total = 0;
+        flow.Run(Range<int>{0, 6}, [&total](std::size_t bytes) {
+            total += bytes;
+            std::cout << "[Processor] Processed " << bytes << " bytes" << std::endl;
+        });
+        std::cout << "[main] " << decltype(flow)::Threads << " threads, total " << total << " bytes" << std::endl;
+
+        // Would not compile - the Filter after the size_t Map expects a string:
+        // (flow | Filter([](const std::string &s) { return !s.empty(); })).Run(Range<int>{0, 6}, [](auto) {});
+    }
+
+    // Step 2: fused vs unfused, 5 stages.
+    // Lambdas, not function pointers: each lambda is its own type, so the call
+    // target is part of the pipeline type and gets inlined (Map(Hash) would
+    // store a pointer and call through it).
+    auto hash = [](std::uint64_t x) { return Hash(x); };
+    auto keepA = [](std::uint64_t x) { return KeepA(x); };
+    auto mix = [](std::uint64_t x) { return Mix(x); };
+    auto keepB = [](std::uint64_t x) { return KeepB(x); };
+    auto low = [](std::uint64_t x) { return Low(x); };
+    const std::uint64_t N = 10000000;
+    std::uint64_t expected = 0;
+    std::cout << "\n5-stage map/filter pipeline, " << N / 1000000 << "M items\n"
+              << std::left << std::setw(40) << "variant" << std::right << std::setw(8) << "threads"
+              << std::setw(12) << "Mitems/s" << std::setw(10) << "ms" << std::endl;
+    {
+        auto begin = Clock::now();
+        for (std::uint64_t i = 0; i < N; ++i) {
+            std::uint64_t x = Hash(i);
+            if (!KeepA(x)) continue;
+            x = Mix(x);
+            if (!KeepB(x)) continue;
+            expected += Low(x);
+        }
+        PrintRow("hand-written loop", 1, N, Seconds(begin), expected, expected);
+    }
+    {
+        auto fused = Pipe() | Map(hash) | Filter(keepA) | Map(mix) | Filter(keepB) | Map(low);
+        std::uint64_t sum = 0;
+        auto begin = Clock::now();
+        fused.Run(Range<std::uint64_t>{0, N}, [&sum](std::uint64_t x) { sum += x; });
+        PrintRow("fused template pipeline", decltype(fused)::Threads, N, Seconds(begin), sum, expected);
+    }
+    {
+        // Runtime-composed: the same stages behind std::function, one indirect call per stage
+        std::vector<std::function<bool(std::uint64_t&)>> stages = {
+            [](std::uint64_t &x) { x = Hash(x); return true; },
+            [](std::uint64_t &x) { return KeepA(x); },
+            [](std::uint64_t &x) { x = Mix(x); return true; },
+            [](std::uint64_t &x) { return KeepB(x); },
+            [](std::uint64_t &x) { x = Low(x); return true; },
+        };
+        std::uint64_t sum = 0;
+        auto begin = Clock::now();
+        for (std::uint64_t i = 0; i < N; ++i) {
+            std::uint64_t x = i;
+            bool keep = true;
+            for (auto &stage : stages) {
+                if (!(keep = stage(x))) break;
+            }
+            if (keep) sum += x;
+        }
+        PrintRow("std::function per stage", 1, N, Seconds(begin), sum, expected);
+    }
+    {
+        auto split = Pipe() | Map(hash) | Filter(keepA) | Hop<4096>() | Map(mix) | Filter(keepB) | Map(low);
+        std::uint64_t sum = 0;
+        auto begin = Clock::now();
+        split.Run(Range<std::uint64_t>{0, N}, [&sum](std::uint64_t x) { sum += x; });
+        PrintRow("fused, 1 hop after stage 2", decltype(split)::Threads, N, Seconds(begin), sum, expected);
+    }
+    {
+        auto unfused = Pipe() | Map(hash) | Hop<4096>() | Filter(keepA) | Hop<4096>() | Map(mix)
+                     | Hop<4096>() | Filter(keepB) | Hop<4096>() | Map(low);
+        std::uint64_t sum = 0;
+        auto begin = Clock::now();
+        unfused.Run(Range<std::uint64_t>{0, N}, [&sum](std::uint64_t x) { sum += x; });
+        PrintRow("unfused: hop between every stage", decltype(unfused)::Threads, N, Seconds(begin), sum, expected);
+    }
+
+    return 0;
+}
+
+/* ------------------------------------------------------------------
+THEORY & KEY POINTS: Compile-time pipelines and stage fusion
+
+1. Stages as types:
+   - Map(f) returns MapStage<F>, where F is the lambda's unique type.
+   - `p | stage` returns Pipeline<Stages..., Stage>: the whole pipeline
+     shape is part of the type, so the compiler sees every stage.
+
+2. Type flow:
+   - StageOutput<In, Stage>::type computes what each stage produces
+     (std::invoke_result for Map, In for Filter/Hop).
+   - static_assert in StageOutput = readable compile errors when a stage
+     cannot accept the previous output.
+
+3. Fusion:
+   - Build<I>() wraps the callable of stage I+1..N in a lambda for stage I:
+     map → next(fn(x)), filter → if (pred(x)) next(x).
+   - Nested lambdas with known types are inlined → one loop body, the same
+     machine code as the hand-written loop. No queue, no allocation, no
+     indirect call per item.
+   - std::function per stage: the compiler cannot see through the call →
+     one indirect call per stage per item, nothing inlined across stages.
+   - Pass lambdas, not function pointers: a pointer's VALUE is the target,
+     a lambda's TYPE is - only the type is visible to the optimizer here.
+
+4. Hops:
+   - Only where parallelism pays (slow I/O stage, expensive stage that
+     should overlap with the rest): Hop<N>() = thread + typed SPSC ring.
+   - Every hop costs a store/load of shared indices + cache-line transfers;
+     per-item hops between cheap stages are far slower than fusing.
+
+5. Shutdown: close ring k, join its consumer (which has pushed everything
+   into ring k+1), then close ring k+1 ... → nothing is lost.
+
+------------------------------------------------------------------
+
+💡 Memory Tip / Analogy
+	•	Fused stages = one cook doing wash → cut → fry in one motion, no plates in between.
+	•	Hop = handing the plate through the kitchen window to the next cook.
+	•	Unfused = a window between every step: most time is spent handing plates around.
+
+*/
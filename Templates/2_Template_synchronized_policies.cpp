@@ -0,0 +1,396 @@
+// 2_Template_synchronized_policies.cpp
+// clang++ -std=c++17 -O2 -pthread 2_Template_synchronized_policies.cpp -o a; ./a
+// @author :  DhiraxD
+// @brief  : Synchronized<T, LockPolicy>: the data and its lock in ONE object,
+//           and the only way to reach the data is through the lock.
+//           Replaces the hand-paired g_Data + g_Mutex (5, 10) and g_data + mtx (9).
+//           - with_lock(fn) / with_rlock(fn), wlock() / rlock() RAII pointers
+//           - lock policy chosen at compile time: MutexPolicy, SpinPolicy,
+//             AdaptivePolicy, RWPolicy (shared reads), NoLockPolicy (1 thread)
+//           - static checks: rlock() is const-only, with_lock(fn) rejects an fn
+//             that returns a reference or T* (the common accidental leak), a
+//             policy must provide what it claims
+//           Benchmark: the push_back workload per policy vs hand-written lock_guard.
+// References:
+// https://en.wikipedia.org/wiki/Modern_C%2B%2B_Design (policy-based design)
+// https://github.com/facebook/folly/blob/main/folly/docs/Synchronized.md
+// https://en.cppreference.com/w/cpp/thread/shared_mutex
+// https://en.cppreference.com/w/cpp/types/is_invocable
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <list>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <shared_mutex>
+#include <atomic>
+#include <chrono>
+#include <type_traits>
+#include <utility>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+inline void CpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+// -----------------------------------------------------------
+// Lock policies. Each one says what kind of lock it is:
+//   mutex_type    : provides lock()/unlock() (and lock_shared()/unlock_shared() if SharedReads)
+//   SharedReads   : rlock() may run concurrently with other readers
+//   ThreadSafe    : false → the object must not be shared between threads
+class SpinLock {
+public:
+    void lock() {
+        while (true) {
+            if (!m_Locked.exchange(true, std::memory_order_acquire)) return;
+            for (int i = 0; m_Locked.load(std::memory_order_relaxed); ++i) {    // test-and-test-and-set
+                if (i < 64) {
+                    CpuRelax();
+                } else {
+                    std::this_thread::yield();      // the owner may not be running at all
+                }
+            }
+        }
+    }
+    bool try_lock() { return !m_Locked.load(std::memory_order_relaxed) && !m_Locked.exchange(true, std::memory_order_acquire); }
+    void unlock() { m_Locked.store(false, std::memory_order_release); }
+
+private:
+    std::atomic<bool> m_Locked{false};
+};
+
+// Spin a little on try_lock(), then block in the kernel like std::mutex
+class AdaptiveMutex {
+public:
+    void lock() {
+        for (int i = 0; i < 100; ++i) {
+            if (m_Mutex.try_lock()) return;
+            CpuRelax();
+        }
+        m_Mutex.lock();
+    }
+    bool try_lock() { return m_Mutex.try_lock(); }
+    void unlock() { m_Mutex.unlock(); }
+
+private:
+    std::mutex m_Mutex;
+};
+
+struct NullMutex {
+    void lock() {}
+    bool try_lock() { return true; }
+    void unlock() {}
+};
+
+struct MutexPolicy {
+    using mutex_type = std::mutex;
+    static constexpr bool SharedReads = false;
+    static constexpr bool ThreadSafe = true;
+};
+
+struct SpinPolicy {
+    using mutex_type = SpinLock;
+    static constexpr bool SharedReads = false;
+    static constexpr bool ThreadSafe = true;
+};
+
+struct AdaptivePolicy {
+    using mutex_type = AdaptiveMutex;
+    static constexpr bool SharedReads = false;
+    static constexpr bool ThreadSafe = true;
+};
+
+struct RWPolicy {
+    using mutex_type = std::shared_mutex;
+    static constexpr bool SharedReads = true;
+    static constexpr bool ThreadSafe = true;
+};
+
+struct NoLockPolicy {
+    using mutex_type = NullMutex;
+    static constexpr bool SharedReads = true;
+    static constexpr bool ThreadSafe = false;
+};
+
+// Detection of lock()/unlock()/lock_shared()/unlock_shared() for the policy checks
+template <typename M, typename = void>
+struct IsLockable : std::false_type {};
+
+template <typename M>
+struct IsLockable<M, std::void_t<decltype(std::declval<M&>().lock()), decltype(std::declval<M&>().unlock())>>
+    : std::true_type {};
+
+template <typename M, typename = void>
+struct IsSharedLockable : std::false_type {};
+
+template <typename M>
+struct IsSharedLockable<M, std::void_t<decltype(std::declval<M&>().lock_shared()),
+                                       decltype(std::declval<M&>().unlock_shared())>> : std::true_type {};
+
+// -----------------------------------------------------------
+template <typename T, typename LockPolicy = MutexPolicy>
+class Synchronized {
+    using Mutex = typename LockPolicy::mutex_type;
+    static_assert(IsLockable<Mutex>::value, "LockPolicy::mutex_type must provide lock() and unlock()");
+    static_assert(!LockPolicy::SharedReads || IsSharedLockable<Mutex>::value || std::is_same_v<Mutex, NullMutex>,
+                  "LockPolicy::SharedReads needs lock_shared() and unlock_shared()");
+
+    static constexpr bool UseSharedLock = LockPolicy::SharedReads && IsSharedLockable<Mutex>::value;
+
+    // Keeps the lock for as long as it lives; the only path to the data
+    template <typename Pointee, bool Shared>
+    class LockedPtr {
+    public:
+        LockedPtr(Pointee &data, Mutex &mutex) : m_Data(&data), m_Mutex(&mutex) {
+            if constexpr (Shared) {
+                m_Mutex->lock_shared();
+            } else {
+                m_Mutex->lock();
+            }
+        }
+        ~LockedPtr() {
+            if (m_Mutex == nullptr) return;
+            if constexpr (Shared) {
+                m_Mutex->unlock_shared();
+            } else {
+                m_Mutex->unlock();
+            }
+        }
+        LockedPtr(LockedPtr &&other) noexcept : m_Data(other.m_Data), m_Mutex(std::exchange(other.m_Mutex, nullptr)) {}
+        LockedPtr(const LockedPtr&) = delete;
+        LockedPtr & operator=(const LockedPtr&) = delete;
+        LockedPtr & operator=(LockedPtr&&) = delete;
+
+        Pointee * operator->() const { return m_Data; }
+        Pointee & operator*() const { return *m_Data; }
+
+    private:
+        Pointee *m_Data;
+        Mutex *m_Mutex;
+    };
+
+public:
+    using WritePtr = LockedPtr<T, false>;
+    using ReadPtr = LockedPtr<const T, UseSharedLock>;     // const: writes through rlock() do not compile
+
+    Synchronized() = default;
+
+    template <typename... Args, typename = std::enable_if_t<std::is_constructible_v<T, Args&&...>>>
+    explicit Synchronized(std::in_place_t, Args&&... args) : m_Data(std::forward<Args>(args)...) {}
+
+    // The lock cannot be copied/moved together with the data safely → neither can we
+    Synchronized(const Synchronized&) = delete;
+    Synchronized & operator=(const Synchronized&) = delete;
+
+    // Exclusive access for the duration of fn.
+    // The static_assert catches fn returning any reference, T* or const T*;
+    // it cannot see through v.data(), iterators, string_views or lambdas that
+    // capture &v - those still outlive the lock and are the caller's bug.
+    template <typename Fn>
+    decltype(auto) with_lock(Fn &&fn) {
+        static_assert(std::is_invocable_v<Fn, T&>, "with_lock(fn): fn must take T&");
+        using R = std::invoke_result_t<Fn, T&>;
+        static_assert(!std::is_reference_v<R> && !std::is_same_v<std::decay_t<R>, T*> && !std::is_same_v<std::decay_t<R>, const T*>,
+                      "with_lock(fn): fn must not return a reference/pointer to the protected data - it would outlive the lock");
+        WritePtr locked(m_Data, m_Mutex);
+        return std::forward<Fn>(fn)(*locked);
+    }
+
+    // Read access; concurrent with other readers if the policy allows it
+    template <typename Fn>
+    decltype(auto) with_rlock(Fn &&fn) const {
+        static_assert(std::is_invocable_v<Fn, const T&>, "with_rlock(fn): fn must take const T&");
+        using R = std::invoke_result_t<Fn, const T&>;
+        static_assert(!std::is_reference_v<R> && !std::is_same_v<std::decay_t<R>, const T*>,
+                      "with_rlock(fn): fn must not return a reference/pointer to the protected data - it would outlive the lock");
+        ReadPtr locked(m_Data, m_Mutex);
+        return std::forward<Fn>(fn)(*locked);
+    }
+
+    // For several statements under one lock: auto data = s.wlock(); data->push_back(..);
+    WritePtr wlock() { return WritePtr(m_Data, m_Mutex); }
+    ReadPtr rlock() const { return ReadPtr(m_Data, m_Mutex); }
+
+    // Copy out under the lock
+    T copy() const { return with_rlock([](const T &data) { return data; }); }
+
+    static constexpr bool ThreadSafe = LockPolicy::ThreadSafe;
+
+private:
+    T m_Data{};
+    mutable Mutex m_Mutex;
+};
+
+// Share an object between threads only if its policy says so
+template <typename S>
+S & Shared(S &object) {
+    static_assert(S::ThreadSafe, "this Synchronized uses NoLockPolicy and must not be shared between threads");
+    return object;
+}
+
+// -----------------------------------------------------------
+// 5_Thread_mutex.cpp with the lock inside the data
+const int SIZE = 100000;
+Synchronized<std::list<int>> g_Data;
+
+void Download() {
+    for (int i = 0; i < SIZE; ++i) {
+        g_Data.with_lock([i](std::list<int> &data) { data.push_back(i); });
+    }
+}
+
+void Download2() {
+    for (int i = 0; i < SIZE; ++i) {
+        g_Data.wlock()->push_back(i);           // the temporary holds the lock for this statement
+    }
+}
+
+template <typename Body>
+double PerOpNs(int threads, int opsPerThread, Body body) {
+    std::vector<std::thread> workers;
+    const auto begin = Clock::now();
+    for (int t = 0; t < threads; ++t) workers.emplace_back(body);
+    for (auto &w : workers) w.join();
+    return std::chrono::duration<double, std::nano>(Clock::now() - begin).count() / (double(threads) * opsPerThread);
+}
+
+template <typename Policy>
+double SynchronizedPushBack(int threads, int ops) {
+    Synchronized<std::vector<int>, Policy> data;
+    auto &shared = Shared(data);
+    const double ns = PerOpNs(threads, ops, [&shared, ops] {
+        for (int i = 0; i < ops; ++i) shared.with_lock([i](std::vector<int> &v) { v.push_back(i); });
+    });
+    if (data.with_rlock([](const std::vector<int> &v) { return v.size(); }) != std::size_t(threads) * ops) return -1;
+    return ns;
+}
+
+int main() {
+    // Step 1: the Download/Download2 example; no g_Mutex to forget
+    std::thread thDownloader(Download);
+    std::thread thDownloader2(Download2);
+    thDownloader.join();
+    thDownloader2.join();
+    std::cout << "[main] list size: " << g_Data.with_rlock([](const std::list<int> &data) { return data.size(); })
+              << std::endl;
+
+    // Step 2: read-mostly data with shared reads
+    Synchronized<std::vector<std::string>, RWPolicy> files(std::in_place, std::vector<std::string>{"a.txt", "b.txt"});
+    {
+        // Never rlock()/wlock() the same Synchronized twice on ONE thread:
+        // lock_shared() on a shared_mutex this thread already holds is UB
+        auto reader1 = files.rlock();
+        std::string front;
+        std::thread reader2([&files, &front] { front = files.rlock()->front(); });   // second reader, same time
+        reader2.join();
+        std::cout << "[main] readers see " << reader1->size() << " and " << front << std::endl;
+        // reader1->push_back("c.txt");     // does not compile: rlock() gives const access
+    }
+    files.wlock()->push_back("c.txt");
+    std::cout << "[main] after write: " << files.copy().size() << " files" << std::endl;
+
+    // Would not compile:
+    // std::vector<std::string> &leak = files.with_lock([](std::vector<std::string> &v) -> std::vector<std::string>& { return v; });
+    // Synchronized<std::vector<int>, NoLockPolicy> local;  Shared(local);
+
+    // Step 3: push_back cost per policy (ns per push_back)
+    const int OPS = 1000000;
+    std::cout << "\npush_back into std::vector<int>, ns per op\n"
+              << std::setw(8) << "threads" << std::setw(12) << "lock_guard" << std::setw(10) << "mutex"
+              << std::setw(10) << "spin" << std::setw(10) << "adaptive" << std::setw(10) << "rw"
+              << std::setw(10) << "none" << std::setw(10) << "raw" << std::endl;
+    for (int threads : {1, 2, 4}) {
+        // hand-written: the 5_Thread_mutex.cpp way
+        std::vector<int> handData;
+        std::mutex handMutex;
+        const double hand = PerOpNs(threads, OPS, [&] {
+            for (int i = 0; i < OPS; ++i) {
+                std::lock_guard<std::mutex> lock(handMutex);
+                handData.push_back(i);
+            }
+        });
+
+        std::cout << std::setw(8) << threads << std::fixed << std::setprecision(1)
+                  << std::setw(12) << hand
+                  << std::setw(10) << SynchronizedPushBack<MutexPolicy>(threads, OPS)
+                  << std::setw(10) << SynchronizedPushBack<SpinPolicy>(threads, OPS)
+                  << std::setw(10) << SynchronizedPushBack<AdaptivePolicy>(threads, OPS)
+                  << std::setw(10) << SynchronizedPushBack<RWPolicy>(threads, OPS);
+        if (threads == 1) {
+            double plain = 0;
+            for (int round = 0; round < 2; ++round) {       // first round only warms up the allocator
+                std::vector<int> raw;
+                plain = PerOpNs(1, OPS, [&raw, OPS] {
+                    for (int i = 0; i < OPS; ++i) raw.push_back(i);
+                });
+            }
+            Synchronized<std::vector<int>, NoLockPolicy> single;
+            const double none = PerOpNs(1, OPS, [&single, OPS] {
+                for (int i = 0; i < OPS; ++i) single.with_lock([i](std::vector<int> &v) { v.push_back(i); });
+            });
+            std::cout << std::setw(10) << none << std::setw(10) << plain;
+        } else {
+            std::cout << std::setw(10) << "-" << std::setw(10) << "-";
+        }
+        std::cout << std::endl;
+    }
+
+    return 0;
+}
+
+/* ------------------------------------------------------------------
+THEORY & KEY POINTS: Synchronized<T, LockPolicy>
+
+1. The bug class:
+   - g_Data + g_Mutex are two unrelated globals; nothing stops code from
+     touching g_Data without g_Mutex, or locking the wrong mutex.
+   - Synchronized<T> stores both and offers NO unlocked accessor.
+
+2. Access API:
+   - with_lock(fn): lock, fn(T&), unlock - exception safe.
+   - wlock()/rlock(): RAII pointer; the lock lives as long as the pointer.
+     `s.wlock()->push_back(x)` locks for exactly one statement.
+   - rlock() returns a pointer to const → mutation does not compile.
+   - Not recursive: a second rlock()/wlock() on the same thread while the
+     first is alive deadlocks (wlock) or is UB (shared_mutex::lock_shared).
+
+3. Compile-time checks:
+   - fn returning a reference, T* or const T* from with_lock() would leak
+     the data past the unlock → static_assert.
+   - Only those return TYPES are checked: a pointer/iterator/view INTO T
+     (v.data(), v.begin(), std::string_view) is just another type and still
+     compiles. The check stops accidents, not a determined caller.
+   - A policy claiming SharedReads must provide lock_shared() (detected
+     with std::void_t), NoLockPolicy objects cannot go through Shared().
+
+4. Policy-based design:
+   - The lock type is a template parameter → chosen at compile time,
+     every call inlined. No virtual calls, no runtime switch.
+   - Mutex: general purpose. Spin: very short critical sections, threads
+     <= cores. Adaptive: spin briefly, then sleep. RW: many readers.
+     NoLock: single-threaded use of the same code → compiles to the raw container.
+
+5. Zero overhead:
+   - Synchronized<mutex> costs the same as lock_guard by hand: the wrapper
+     disappears after inlining.
+   - The cost that remains is the LOCK itself; the policy decides that.
+
+------------------------------------------------------------------
+
+💡 Memory Tip / Analogy
+	•	g_Data + g_Mutex = a safe and its key kept in different rooms.
+	•	Synchronized = a safe-deposit box: the only way to the contents is opening the box.
+	•	Lock policy = choosing the box's lock: key, combination, or none for your own drawer at home.
+
+*/
@@ -0,0 +1,451 @@
+// 3_Template_expression_arrays.cpp
+// clang++ -std=c++17 -O2 -pthread 3_Template_expression_arrays.cpp -o a; ./a [maxElements]
+// @author :  DhiraxD
+// @brief  : Expression templates: `r = a + b * c` builds a lazy expression TYPE,
+//           evaluated in ONE fused loop when assigned - no temporary arrays.
+//           - Array<T>: 64-byte aligned storage, counts its allocations
+//           - Expr nodes: ArrayView, Scalar, BinaryExpr<Op, L, R>; operators + - * /
+//           - evaluation loop written for the auto-vectorizer (SIMD)
+//           - optional Parallel{} policy splits the range over threads
+//           Benchmark vs naive Add/Mul returning new arrays (the Add/mul of 3 and 6)
+//           and vs hand-written loops, 1K .. 100M elements.
+// References:
+// https://en.wikipedia.org/wiki/Expression_templates
+// https://en.wikipedia.org/wiki/Curiously_recurring_template_pattern
+// https://eigen.tuxfamily.org/dox/TopicLazyEvaluation.html
+// https://gcc.gnu.org/projects/tree-ssa/vectorization.html
+// https://llvm.org/docs/Vectorizers.html
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <algorithm>
+#include <utility>
+#include <atomic>
+
+using Clock = std::chrono::steady_clock;
+
+// Element-wise loops read and write the same index → no loop-carried dependency,
+// tell the vectorizer so it does not need runtime alias checks
+#if defined(__clang__)
+#define VECTORIZE_LOOP _Pragma("clang loop vectorize(assume_safety) interleave(enable)")
+#elif defined(__GNUC__)
+#define VECTORIZE_LOOP _Pragma("GCC ivdep")
+#else
+#define VECTORIZE_LOOP
+#endif
+
+std::atomic<long> g_Allocations{0};
+
+// -----------------------------------------------------------
+// Expression nodes. Every node has size() and operator[](i); nothing is computed
+// until an Array is assigned from the expression.
+template <typename E>
+struct Expr {
+    const E & self() const { return static_cast<const E&>(*this); }
+};
+
+// Leaf: pointer + size, copied by value into the expression tree
+template <typename T>
+class ArrayView : public Expr<ArrayView<T>> {
+public:
+    using value_type = T;
+    ArrayView(const T *data, std::size_t size) : m_Data(data), m_Size(size) {}
+    T operator[](std::size_t i) const { return m_Data[i]; }
+    std::size_t size() const { return m_Size; }
+
+private:
+    const T *m_Data;
+    std::size_t m_Size;
+};
+
+// Leaf: a number broadcast to every index; size 0 = "fits any size"
+template <typename T>
+class Scalar : public Expr<Scalar<T>> {
+public:
+    using value_type = T;
+    explicit Scalar(T value) : m_Value(value) {}
+    T operator[](std::size_t) const { return m_Value; }
+    std::size_t size() const { return 0; }
+
+private:
+    T m_Value;
+};
+
+struct Plus { template <typename A, typename B> static auto Apply(A a, B b) { return a + b; } };
+struct Minus { template <typename A, typename B> static auto Apply(A a, B b) { return a - b; } };
+struct Multiplies { template <typename A, typename B> static auto Apply(A a, B b) { return a * b; } };
+struct Divides { template <typename A, typename B> static auto Apply(A a, B b) { return a / b; } };
+
+template <typename Op, typename L, typename R>
+class BinaryExpr : public Expr<BinaryExpr<Op, L, R>> {
+public:
+    using value_type = decltype(Op::Apply(std::declval<typename L::value_type>(), std::declval<typename R::value_type>()));
+
+    BinaryExpr(const L &l, const R &r) : m_L(l), m_R(r) {
+        if (l.size() != 0 && r.size() != 0 && l.size() != r.size()) {
+            throw std::length_error("expression: operand sizes differ (" + std::to_string(l.size()) + " vs " +
+                                    std::to_string(r.size()) + ")");
+        }
+    }
+    value_type operator[](std::size_t i) const { return Op::Apply(m_L[i], m_R[i]); }
+    std::size_t size() const { return m_L.size() != 0 ? m_L.size() : m_R.size(); }
+
+private:
+    L m_L;      // by value: leaves are a pointer + size, inner nodes are small structs
+    R m_R;
+};
+
+// -----------------------------------------------------------
+struct Sequential {};
+
+// hardware_concurrency() reads /sys on Linux → ask once
+inline unsigned HardwareThreads() {
+    static const unsigned s_Threads = std::max(1u, std::thread::hardware_concurrency());
+    return s_Threads;
+}
+
+struct Parallel {
+    unsigned threads = HardwareThreads();
+    std::size_t minPerThread = 1 << 16;      // below this, thread start-up costs more than the loop
+};
+
+// Fixed-size blocks: a constant trip count the vectorizer handles even with its
+// cheapest cost model (-O2), the remainder runs scalar
+constexpr std::size_t BLOCK = 16;
+
+template <typename T, typename E>
+void EvaluateRange(T *out, const E &expr, std::size_t begin, std::size_t end) {
+    const E local = expr;       // pointers in registers, not reloaded after every store
+    std::size_t i = begin;
+    for (; i + BLOCK <= end; i += BLOCK) {
+        VECTORIZE_LOOP
+        for (std::size_t k = 0; k < BLOCK; ++k) {
+            out[i + k] = static_cast<T>(local[i + k]);
+        }
+    }
+    for (; i < end; ++i) {
+        out[i] = static_cast<T>(local[i]);
+    }
+}
+
+template <typename T>
+class Array {
+public:
+    using value_type = T;
+
+    explicit Array(std::size_t size, T value = T{}) : m_Data(Allocate(size)), m_Size(size) {
+        std::fill_n(m_Data.get(), size, value);
+    }
+
+    // r = expression: ONE allocation for the result, ONE pass over the data
+    template <typename E>
+    Array(const Expr<E> &expr) : m_Data(Allocate(expr.self().size())), m_Size(expr.self().size()) {
+        EvaluateRange(m_Data.get(), expr.self(), 0, m_Size);
+    }
+
+    Array(const Array &other) : m_Data(Allocate(other.m_Size)), m_Size(other.m_Size) {
+        std::memcpy(m_Data.get(), other.m_Data.get(), m_Size * sizeof(T));
+    }
+    // moved-from array is empty (size 0), never "size n with no buffer"
+    Array(Array &&other) noexcept : m_Data(std::move(other.m_Data)), m_Size(std::exchange(other.m_Size, 0)) {}
+    Array & operator=(Array &&other) noexcept {
+        m_Data = std::move(other.m_Data);
+        m_Size = std::exchange(other.m_Size, 0);
+        return *this;
+    }
+    // Copy-assign behaves like std::vector: a different size reallocates,
+    // only expression assignment insists on matching sizes
+    Array & operator=(const Array &other) {
+        if (other.m_Size != m_Size) {
+            m_Data.reset(Allocate(other.m_Size));
+            m_Size = other.m_Size;
+        }
+        return Assign(ArrayView<T>(other.data(), other.size()));
+    }
+
+    template <typename E>
+    Array & operator=(const Expr<E> &expr) { return Assign(expr); }
+
+    // Evaluate into the existing storage; `a = a + b` is fine, element i only reads index i
+    template <typename E, typename Policy = Sequential>
+    Array & Assign(const Expr<E> &expr, Policy policy = {}) {
+        const E &e = expr.self();
+        if (e.size() != 0 && e.size() != m_Size) {
+            throw std::length_error("Array::Assign: size " + std::to_string(m_Size) + ", expression " +
+                                    std::to_string(e.size()));
+        }
+        if constexpr (std::is_same_v<Policy, Parallel>) {
+            const std::size_t threads = std::min<std::size_t>(policy.threads, m_Size / std::max<std::size_t>(1, policy.minPerThread));
+            if (threads > 1) {
+                // chunks rounded to a cache line so two threads never write the same line
+                const std::size_t perLine = 64 / sizeof(T) > 0 ? 64 / sizeof(T) : 1;
+                const std::size_t perThread = (m_Size + threads - 1) / threads;
+                const std::size_t chunk = (perThread + perLine - 1) / perLine * perLine;
+                std::vector<std::thread> workers;
+                for (std::size_t t = 1; t < threads; ++t) {
+                    const std::size_t begin = std::min(m_Size, t * chunk);
+                    const std::size_t end = std::min(m_Size, begin + chunk);
+                    workers.emplace_back([this, &e, begin, end] { EvaluateRange(m_Data.get(), e, begin, end); });
+                }
+                EvaluateRange(m_Data.get(), e, 0, std::min(m_Size, chunk));
+                for (auto &w : workers) w.join();
+                return *this;
+            }
+        }
+        EvaluateRange(m_Data.get(), e, 0, m_Size);
+        return *this;
+    }
+
+    T & operator[](std::size_t i) { return m_Data[i]; }
+    const T & operator[](std::size_t i) const { return m_Data[i]; }
+    T * data() { return m_Data.get(); }
+    const T * data() const { return m_Data.get(); }
+    std::size_t size() const { return m_Size; }
+
+private:
+    struct FreeDeleter { void operator()(T *p) const { std::free(p); } };
+
+    static T * Allocate(std::size_t size) {
+        const std::size_t bytes = std::max<std::size_t>(64, (size * sizeof(T) + 63) / 64 * 64);
+        void *p = std::aligned_alloc(64, bytes);
+        if (p == nullptr) throw std::bad_alloc();
+        g_Allocations.fetch_add(1, std::memory_order_relaxed);
+        return static_cast<T*>(p);
+    }
+
+    std::unique_ptr<T[], FreeDeleter> m_Data;
+    std::size_t m_Size;
+};
+
+// -----------------------------------------------------------
+// Operators: any mix of Array, expression and arithmetic scalar (at least one non-scalar)
+template <typename X> struct IsArray : std::false_type {};
+template <typename T> struct IsArray<Array<T>> : std::true_type {};
+
+template <typename X>
+constexpr bool IsExpression = std::is_base_of_v<Expr<X>, X>;
+
+template <typename X>
+constexpr bool IsOperand = IsArray<X>::value || IsExpression<X> || std::is_arithmetic_v<X>;
+
+template <typename X>
+auto AsNode(const X &x) {
+    if constexpr (IsArray<X>::value) {
+        return ArrayView<typename X::value_type>(x.data(), x.size());
+    } else if constexpr (std::is_arithmetic_v<X>) {
+        return Scalar<X>(x);
+    } else {
+        return x;
+    }
+}
+
+template <typename L, typename R>
+using EnableIfOperands = std::enable_if_t<IsOperand<L> && IsOperand<R> &&
+                                          !(std::is_arithmetic_v<L> && std::is_arithmetic_v<R>)>;
+
+template <typename Op, typename L, typename R>
+auto MakeBinary(const L &l, const R &r) {
+    auto left = AsNode(l);
+    auto right = AsNode(r);
+    return BinaryExpr<Op, decltype(left), decltype(right)>(left, right);
+}
+
+template <typename L, typename R, typename = EnableIfOperands<L, R>>
+auto operator+(const L &l, const R &r) { return MakeBinary<Plus>(l, r); }
+
+template <typename L, typename R, typename = EnableIfOperands<L, R>>
+auto operator-(const L &l, const R &r) { return MakeBinary<Minus>(l, r); }
+
+template <typename L, typename R, typename = EnableIfOperands<L, R>>
+auto operator*(const L &l, const R &r) { return MakeBinary<Multiplies>(l, r); }
+
+template <typename L, typename R, typename = EnableIfOperands<L, R>>
+auto operator/(const L &l, const R &r) { return MakeBinary<Divides>(l, r); }
+
+// -----------------------------------------------------------
+// The naive way: the Add/mul building blocks of 3 and 6 on arrays, one new Array each
+Array<float> Add(const Array<float> &a, const Array<float> &b) {
+    Array<float> r(a.size());
+    for (std::size_t i = 0; i < a.size(); ++i) r[i] = a[i] + b[i];
+    return r;
+}
+
+Array<float> Sub(const Array<float> &a, const Array<float> &b) {
+    Array<float> r(a.size());
+    for (std::size_t i = 0; i < a.size(); ++i) r[i] = a[i] - b[i];
+    return r;
+}
+
+Array<float> Mul(const Array<float> &a, const Array<float> &b) {
+    Array<float> r(a.size());
+    for (std::size_t i = 0; i < a.size(); ++i) r[i] = a[i] * b[i];
+    return r;
+}
+
+Array<float> Scale(float k, const Array<float> &a) {
+    Array<float> r(a.size());
+    for (std::size_t i = 0; i < a.size(); ++i) r[i] = k * a[i];
+    return r;
+}
+
+// -----------------------------------------------------------
+struct Result {
+    double nsPerElement;
+    double allocationsPerRun;
+};
+
+template <typename Fn>
+Result Measure(std::size_t n, Fn fn) {
+    const int runs = static_cast<int>(std::max<std::size_t>(1, 50000000 / n));
+    fn();       // warm-up: page in the output, load the code
+    const long allocationsBefore = g_Allocations.load();
+    const auto begin = Clock::now();
+    for (int r = 0; r < runs; ++r) fn();
+    const double ns = std::chrono::duration<double, std::nano>(Clock::now() - begin).count();
+    return {ns / (double(runs) * n), double(g_Allocations.load() - allocationsBefore) / runs};
+}
+
+bool Same(const Array<float> &x, const Array<float> &y) {
+    for (std::size_t i = 0; i < x.size(); ++i) {
+        if (x[i] != y[i]) return false;
+    }
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    // 100M floats = 400 MB per array; the naive long expression keeps ~7 arrays alive
+    const std::size_t maxElements = argc > 1 ? std::stoull(argv[1]) : 100000000;
+
+    // Step 1: an expression is just a type; nothing runs until assignment
+    {
+        Array<float> a(4, 1.0f), b(4, 2.0f), c(4, 3.0f);
+        auto lazy = a + b * c;      // BinaryExpr<Plus, ArrayView, BinaryExpr<Multiplies, ...>>
+        const long before = g_Allocations.load();
+        Array<float> r = lazy;
+        std::cout << "[main] a + b * c = " << r[0] << ", allocations: " << g_Allocations.load() - before << std::endl;
+        r = r * 0.5f + a;           // evaluated into r's storage: 0 allocations
+        std::cout << "[main] r * 0.5 + a = " << r[0] << ", total allocations: " << g_Allocations.load() - before << std::endl;
+        try {
+            Array<float> d(5);
+            r = a + d;
+        } catch (const std::length_error &ex) {
+            std::cout << "[main] " << ex.what() << std::endl;
+        }
+        Array<float> e(2, 7.0f);
+        e = r;                      // plain copy: resized like std::vector, no length_error
+        std::cout << "[main] copy-assign 2 <- 4 elements: size " << e.size() << ", e[3] = " << e[3] << std::endl;
+        Array<float> taken = std::move(e);      // e is now empty: size 0, no buffer
+        e = r;                                  // ... and usable again
+        std::cout << "[main] after move: taken.size() = " << taken.size() << ", e.size() = " << e.size() << std::endl;
+    }
+
+    // Step 2: benchmark, ns per element (allocations per evaluation)
+    std::cout << "\nns per element (allocations per evaluation), " << std::thread::hardware_concurrency()
+              << " hardware thread(s)\n";
+    std::cout << std::setw(11) << "elements" << " | "
+              << std::setw(14) << "naive" << std::setw(8) << "hand" << std::setw(8) << "expr" << std::setw(8) << "par"
+              << " | " << std::setw(14) << "naive" << std::setw(8) << "hand" << std::setw(8) << "expr" << std::setw(8) << "par"
+              << "\n" << std::setw(11) << "" << " | " << std::setw(38) << "r = a + b * c"
+              << " | " << std::setw(38) << "r = (a + b) * (c - a) + 0.5 * b" << std::endl;
+
+    for (std::size_t n = 1000; n <= maxElements; n *= 10) {
+        Array<float> a(n), b(n), c(n), r(n), check(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            a[i] = float(i % 1000) * 0.001f;
+            b[i] = float(i % 7) + 1.0f;
+            c[i] = float(i % 13) - 6.0f;
+        }
+
+        const Result naive = Measure(n, [&] { r = Add(a, Mul(b, c)); });
+        const Result hand = Measure(n, [&] {
+            float *out = r.data();
+            const float *pa = a.data(), *pb = b.data(), *pc = c.data();
+            for (std::size_t i = 0; i < n; ++i) out[i] = pa[i] + pb[i] * pc[i];
+        });
+        check = r;
+        const Result expr = Measure(n, [&] { r = a + b * c; });
+        const bool ok1 = Same(r, check);
+        const Result par = Measure(n, [&] { r.Assign(a + b * c, Parallel{}); });
+        const bool ok2 = Same(r, check);
+
+        const Result naiveLong = Measure(n, [&] { r = Add(Mul(Add(a, b), Sub(c, a)), Scale(0.5f, b)); });
+        check = r;
+        const Result handLong = Measure(n, [&] {
+            float *out = r.data();
+            const float *pa = a.data(), *pb = b.data(), *pc = c.data();
+            for (std::size_t i = 0; i < n; ++i) out[i] = (pa[i] + pb[i]) * (pc[i] - pa[i]) + 0.5f * pb[i];
+        });
+        const Result exprLong = Measure(n, [&] { r = (a + b) * (c - a) + 0.5f * b; });
+        const bool ok3 = Same(r, check);
+        const Result parLong = Measure(n, [&] { r.Assign((a + b) * (c - a) + 0.5f * b, Parallel{}); });
+        const bool ok4 = Same(r, check);
+
+        std::cout << std::setw(11) << n << " | " << std::fixed << std::setprecision(2)
+                  << std::setw(8) << naive.nsPerElement << " (" << std::setprecision(0) << naive.allocationsPerRun << ")"
+                  << std::setprecision(2) << std::setw(10) << hand.nsPerElement << std::setw(8) << expr.nsPerElement
+                  << std::setw(8) << par.nsPerElement << " | "
+                  << std::setw(8) << naiveLong.nsPerElement << " (" << std::setprecision(0) << naiveLong.allocationsPerRun << ")"
+                  << std::setprecision(2) << std::setw(10) << handLong.nsPerElement << std::setw(8) << exprLong.nsPerElement
+                  << std::setw(8) << parLong.nsPerElement
+                  << ((ok1 && ok2 && ok3 && ok4) ? "" : "  MISMATCH") << std::endl;
+    }
+
+    return 0;
+}
+
+/* ------------------------------------------------------------------
+THEORY & KEY POINTS: Expression templates
+
+1. The problem with operator+ returning an Array:
+   - r = a + b * c → tmp1 = b * c (allocate, loop), tmp2 = a + tmp1 (allocate,
+     loop), r = tmp2. Two allocations, two passes, 5 arrays of memory traffic
+     instead of 4, and cold pages (page faults) in every fresh temporary.
+
+2. The trick:
+   - operator* returns BinaryExpr<Multiplies, ArrayView, ArrayView>, a tiny struct.
+   - operator+ wraps it: BinaryExpr<Plus, ArrayView, BinaryExpr<...>>.
+   - Array::operator=(Expr) runs ONE loop: out[i] = expr[i]; after inlining
+     expr[i] is just a[i] + b[i] * c[i] - the hand-written loop.
+
+3. CRTP:
+   - Expr<E> is the common base; self() casts to the real node type at compile
+     time → no virtual calls, everything inlines.
+
+4. SIMD:
+   - The fused loop is a plain indexed loop over raw pointers → the compiler
+     vectorizes it (SSE/AVX/NEON). `GCC ivdep` / `clang assume_safety` say that
+     out[i] never overlaps a later read, so no runtime alias checks.
+   - Fixed 16-element blocks give the loop a constant trip count, which GCC's
+     cheap -O2 cost model accepts; the plain hand loop needs a runtime alias
+     check and stays scalar at -O2 → the expression can beat it.
+   - Strict IEEE: no reassociation, the float results are bit-identical to the hand loop.
+
+5. Parallel:
+   - Assign(expr, Parallel{}) splits [0, n) into cache-line-aligned chunks.
+   - Only helps for large arrays (≥ 64K per thread) and only up to memory
+     bandwidth; on one core it is the sequential loop plus thread start-up.
+
+6. Pitfalls:
+   - `auto e = a + b;` stores POINTERS into a and b: e must not outlive them.
+   - Size mismatches are found when the expression is built (std::length_error).
+   - Big element-wise kernels are memory-bound: at 10M+ elements fusion wins
+     because it moves fewer bytes, not because it computes faster.
+
+------------------------------------------------------------------
+
+💡 Memory Tip / Analogy
+	•	Naive operators = cooking each ingredient in its own pot, then pouring pots together.
+	•	Expression template = writing the recipe first, then cooking everything in one pan.
+	•	Parallel = several cooks, each with a slice of the same recipe.
+
+*/